@@ -75,8 +75,10 @@ static void st7565r_interface_init(void)
  */
 void st7565r_init(void)
 {
+#ifndef ST7565R_RESET_EXTERNAL
 	// Do a hard reset of the LCD display controller
 	st7565r_hard_reset();
+#endif
 
 	// Initialize the interface
 	st7565r_interface_init();
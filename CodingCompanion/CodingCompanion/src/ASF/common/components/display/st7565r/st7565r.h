@@ -229,6 +229,34 @@ static inline void st7565r_write_data(uint8_t data)
 #endif
 }
 
+/**
+ * \brief Write a run of data to the display controller
+ *
+ * Same as calling st7565r_write_data() for each byte, but the controller is
+ * selected and pin A0 set only once, so the bytes are streamed back to back.
+ *
+ * \param data the data to write
+ * \param len number of bytes to write
+ */
+static inline void st7565r_write_data_buffer(const uint8_t *data, uint8_t len)
+{
+#if defined(ST7565R_USART_SPI_INTERFACE)
+	struct usart_spi_device device = {.id = ST7565R_CS_PIN};
+	usart_spi_select_device(ST7565R_USART_SPI, &device);
+	ioport_set_pin_high(ST7565R_A0_PIN);
+	usart_spi_write_packet(ST7565R_USART_SPI, data, len);
+	ioport_set_pin_low(ST7565R_A0_PIN);
+	usart_spi_deselect_device(ST7565R_USART_SPI, &device);
+#elif defined(ST7565R_SPI_INTERFACE)
+	struct spi_device device = {.id = ST7565R_CS_PIN};
+	spi_select_device(ST7565R_SPI, &device);
+	ioport_set_pin_high(ST7565R_A0_PIN);
+	spi_write_packet(ST7565R_SPI, data, len);
+	ioport_set_pin_low(ST7565R_A0_PIN);
+	spi_deselect_device(ST7565R_SPI, &device);
+#endif
+}
+
 /**
  * \brief Read data from the controller
  *
@@ -288,18 +316,29 @@ static inline void st7565r_hard_reset(void)
 //@{
 /**
  * \brief Enable the LCD sleep mode
+ *
+ * The controller enters its power save mode on the display off command
+ * followed by all points on, which stops the oscillator and the LCD power
+ * circuits. ST7565R_CMD_SLEEP_MODE is the static indicator command on this
+ * controller and expects a register byte after it, so it is not sent. The
+ * display RAM keeps its content and can still be written.
  */
 static inline void st7565r_sleep_enable(void)
 {
-	st7565r_write_command(ST7565R_CMD_SLEEP_MODE);
+	st7565r_write_command(ST7565R_CMD_DISPLAY_OFF);
+	st7565r_write_command(ST7565R_CMD_DISPLAY_ALL_POINTS_ON);
 }
 
 /**
  * \brief Disable the LCD sleep mode
+ *
+ * Leaves the power save mode with all points off, and turns the display
+ * back on.
  */
 static inline void st7565r_sleep_disable(void)
 {
-	st7565r_write_command(ST7565R_CMD_NORMAL_MODE);
+	st7565r_write_command(ST7565R_CMD_DISPLAY_ALL_POINTS_OFF);
+	st7565r_write_command(ST7565R_CMD_DISPLAY_ON);
 }
 //@}
 
@@ -155,20 +155,28 @@ void sysclk_init(void)
 
 void sysclk_enable_module(enum sysclk_port_id port, uint8_t id)
 {
+#ifdef CONFIG_SYSCLK_ENABLE_MODULE_HOOK
+	CONFIG_SYSCLK_ENABLE_MODULE_HOOK(port, id);
+#else
 	irqflags_t flags = cpu_irq_save();
 
 	*((uint8_t *)&PR.PRGEN + port) &= ~id;
 
 	cpu_irq_restore(flags);
+#endif
 }
 
 void sysclk_disable_module(enum sysclk_port_id port, uint8_t id)
 {
+#ifdef CONFIG_SYSCLK_DISABLE_MODULE_HOOK
+	CONFIG_SYSCLK_DISABLE_MODULE_HOOK(port, id);
+#else
 	irqflags_t flags = cpu_irq_save();
 
 	*((uint8_t *)&PR.PRGEN + port) |= id;
 
 	cpu_irq_restore(flags);
+#endif
 }
 
 #if XMEGA_AU || XMEGA_B || XMEGA_C || defined(__DOXYGEN__)
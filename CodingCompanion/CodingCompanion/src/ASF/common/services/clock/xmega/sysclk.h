@@ -477,6 +477,9 @@ enum sysclk_port_id {
  */
 static inline uint32_t sysclk_get_main_hz(void)
 {
+#ifdef CONFIG_SYSCLK_MAIN_HZ_HOOK
+	return CONFIG_SYSCLK_MAIN_HZ_HOOK();
+#else
 	switch (CONFIG_SYSCLK_SOURCE) {
 	case SYSCLK_SRC_RC2MHZ:
 		return 2000000UL;
@@ -508,6 +511,7 @@ static inline uint32_t sysclk_get_main_hz(void)
 		//unhandled_case(CONFIG_SYSCLK_SOURCE);
 		return 0;
 	}
+#endif
 }
 
 /**
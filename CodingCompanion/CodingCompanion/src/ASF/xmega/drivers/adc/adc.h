@@ -455,6 +455,9 @@ void adc_set_callback(ADC_t *adc, adc_callback_t callback);
 void adc_enable(ADC_t *adc);
 void adc_disable(ADC_t *adc);
 bool adc_is_enabled(ADC_t *adc);
+/* Counted peripheral clock, for gating an enabled ADC while it is idle */
+void adc_enable_clock(ADC_t *adc);
+void adc_disable_clock(ADC_t *adc);
 
 /**
  * \brief Start one-shot conversion on ADC channel(s)
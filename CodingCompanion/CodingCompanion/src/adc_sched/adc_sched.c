@@ -0,0 +1,376 @@
+/**
+ * \file
+ *
+ * \brief ADC sampling scheduler
+ *
+ */
+#include <asf.h>
+#include <isr_prof/isr_prof.h>
+#include <clock_scale/clock_scale.h>
+#include <sleep_stats/sleep_stats.h>
+#include "adc_sched.h"
+
+//! \internal Registered sensors
+static struct adc_sched_sensor adc_sched_sensors[CONFIG_ADC_SCHED_MAX_SENSORS];
+//! \internal Precomputed channel CTRL/MUXCTRL of each sensor
+static struct adc_channel_config adc_sched_ch_conf[CONFIG_ADC_SCHED_MAX_SENSORS];
+//! \internal Ticks left until each sensor is due
+static uint16_t adc_sched_countdown[CONFIG_ADC_SCHED_MAX_SENSORS];
+static uint8_t adc_sched_nr_of_sensors;
+
+//! \internal Sensors waiting for a free sweep, bit n for sensor n
+static volatile uint8_t adc_sched_pending;
+//! \internal Channels with a conversion in flight
+static volatile uint8_t adc_sched_busy;
+//! \internal Sensor currently mapped on each channel, 0xff if none
+static uint8_t adc_sched_ch_sensor[ADC_SCHED_NR_OF_CHANNELS];
+//! \internal Whether new sweeps are held back for a clock switch
+static volatile bool adc_sched_held;
+
+static struct clock_scale_notifier adc_sched_clock_notifier;
+//! \internal Whether the scheduler holds the clock of the ADC
+static bool adc_sched_clocked;
+
+//! \internal Last result of each sensor, waiting for its callback
+static adc_result_t adc_sched_results[CONFIG_ADC_SCHED_MAX_SENSORS];
+//! \internal Sensors with a result not yet handed over, bit n for sensor n
+static volatile uint8_t adc_sched_done;
+static struct work adc_sched_work;
+
+/**
+ * \internal
+ * \brief Stop the clock of the ADC once no sweep is in flight
+ *
+ * The ADC stays enabled, so it needs no start-up time when the clock is
+ * started again for the next sweep.
+ *
+ * \note Must be called with interrupts disabled or from the ADC interrupt.
+ */
+static void adc_sched_release(void)
+{
+	if (!adc_sched_busy && adc_sched_clocked) {
+		adc_disable_clock(&ADC_SCHED_ADC);
+		adc_sched_clocked = false;
+	}
+}
+
+/**
+ * \internal
+ * \brief Start the next sweep if the ADC is idle
+ *
+ * Takes the first pending sensor and packs every other pending sensor with the
+ * same reference behind it, up to the number of channels. Channel registers
+ * are only rewritten if a different sensor was mapped there before.
+ *
+ * \note Must be called with interrupts disabled or from the ADC interrupt.
+ */
+static void adc_sched_start_sweep(void)
+{
+	uint8_t pending = adc_sched_pending;
+	uint8_t ch_mask = 0;
+	uint8_t ch = 0;
+	enum adc_reference ref;
+	uint8_t i;
+
+	if (adc_sched_busy || !pending || adc_sched_held) {
+		return;
+	}
+
+	if (!adc_sched_clocked) {
+		adc_enable_clock(&ADC_SCHED_ADC);
+		adc_sched_clocked = true;
+	}
+
+	for (i = 0; !(pending & (1 << i)); i++) {
+	}
+	ref = adc_sched_sensors[i].ref;
+
+	for (; i < adc_sched_nr_of_sensors && ch < ADC_SCHED_NR_OF_CHANNELS;
+			i++) {
+		if (!(pending & (1 << i)) || (adc_sched_sensors[i].ref != ref)) {
+			continue;
+		}
+		if (adc_sched_ch_sensor[ch] != i) {
+			ADC_CH_t *adc_ch = adc_get_channel(&ADC_SCHED_ADC, 1 << ch);
+
+			adc_ch->CTRL = adc_sched_ch_conf[i].ctrl;
+			adc_ch->MUXCTRL = adc_sched_ch_conf[i].muxctrl;
+			adc_sched_ch_sensor[ch] = i;
+		}
+		pending &= ~(1 << i);
+		ch_mask |= 1 << ch;
+		isr_prof_expect((enum isr_prof_vector)(ISR_PROF_ADC_CH0 + ch),
+				CONFIG_ISR_PROF_ADC_CONV_US
+				+ ch * CONFIG_ISR_PROF_ADC_CH_US);
+		ch++;
+	}
+
+	if ((ADC_SCHED_ADC.REFCTRL & ADC_REFSEL_gm) != ref) {
+		ADC_SCHED_ADC.REFCTRL = (ADC_SCHED_ADC.REFCTRL & ~ADC_REFSEL_gm) | ref;
+	}
+
+	adc_sched_pending = pending;
+	adc_sched_busy = ch_mask;
+	adc_start_conversion(&ADC_SCHED_ADC, ch_mask);
+}
+
+/**
+ * \internal
+ * \brief Callback for the ADC conversion complete
+ *
+ * Stores the result of the sensor mapped on the channel for its callback,
+ * and starts the next sweep once every channel of the current one is done.
+ *
+ * \param adc the ADC from which the interrupt came
+ * \param ch_mask the ch_mask that produced the interrupt
+ * \param result the result from the ADC
+ */
+static void adc_sched_handler(ADC_t *adc, uint8_t ch_mask, adc_result_t result)
+{
+	uint8_t ch = 0;
+	uint8_t sensor;
+
+	sleep_stats_wakeup(SLEEP_STATS_ADC);
+	while (!(ch_mask & (1 << ch))) {
+		ch++;
+	}
+	isr_prof_enter((enum isr_prof_vector)(ISR_PROF_ADC_CH0 + ch));
+	sensor = adc_sched_ch_sensor[ch];
+	adc_sched_busy &= ~ch_mask;
+
+	adc_sched_results[sensor] = result;
+	adc_sched_done |= 1 << sensor;
+	work_post(&adc_sched_work);
+
+	adc_sched_start_sweep();
+	adc_sched_release();
+}
+
+/**
+ * \internal
+ * \brief Hand the stored results to the sensor callbacks
+ *
+ * Runs from the work queue, so a callback may take its time and request
+ * the next conversion of its sensor.
+ */
+static void adc_sched_work_handler(void)
+{
+	adc_result_t result;
+	irqflags_t flags;
+	bool done;
+
+	for (uint8_t i = 0; i < adc_sched_nr_of_sensors; i++) {
+		flags = cpu_irq_save();
+		done = adc_sched_done & (1 << i);
+		adc_sched_done &= ~(1 << i);
+		result = adc_sched_results[i];
+		cpu_irq_restore(flags);
+
+		if (done) {
+			adc_sched_sensors[i].callback(i, result);
+		}
+	}
+}
+
+/**
+ * \internal
+ * \brief Callback for clock switches
+ *
+ * Lets the sweep in flight finish on the old clock and holds back the next
+ * one until the prescaler is derived again for ADC_SCHED_CLOCK_HZ.
+ */
+static void adc_sched_clock_handler(enum clock_scale_event event)
+{
+	struct adc_config adc_conf;
+
+	if (event == CLOCK_SCALE_PRE_CHANGE) {
+		adc_sched_held = true;
+		while (adc_sched_busy) {
+		}
+		return;
+	}
+
+	adc_set_clock_rate(&adc_conf, ADC_SCHED_CLOCK_HZ);
+	adc_enable_clock(&ADC_SCHED_ADC);
+	ADC_SCHED_ADC.PRESCALER = adc_conf.prescaler;
+	adc_disable_clock(&ADC_SCHED_ADC);
+	adc_sched_held = false;
+	adc_sched_start_sweep();
+}
+
+/**
+ * \brief Initialize the ADC for scheduled sampling
+ *
+ * Configures ADCA for signed 12-bit manual-triggered conversions and enables
+ * the completion interrupt of all channels. Sensors are added afterwards with
+ * adc_sched_register().
+ */
+void adc_sched_init(void)
+{
+	struct adc_config adc_conf;
+	struct adc_channel_config adc_ch_conf;
+
+	adc_read_configuration(&ADC_SCHED_ADC, &adc_conf);
+	adc_set_conversion_parameters(&adc_conf, ADC_SIGN_ON, ADC_RES_12,
+			ADC_REF_VCC);
+	adc_set_clock_rate(&adc_conf, ADC_SCHED_CLOCK_HZ);
+	adc_set_conversion_trigger(&adc_conf, ADC_TRIG_MANUAL, 1, 0);
+	adc_write_configuration(&ADC_SCHED_ADC, &adc_conf);
+	adc_set_callback(&ADC_SCHED_ADC, &adc_sched_handler);
+
+	for (uint8_t ch = 0; ch < ADC_SCHED_NR_OF_CHANNELS; ch++) {
+		adcch_read_configuration(&ADC_SCHED_ADC, 1 << ch, &adc_ch_conf);
+		adcch_set_interrupt_mode(&adc_ch_conf, ADCCH_MODE_COMPLETE);
+		adcch_enable_interrupt(&adc_ch_conf);
+		adcch_write_configuration(&ADC_SCHED_ADC, 1 << ch, &adc_ch_conf);
+		adc_sched_ch_sensor[ch] = 0xff;
+	}
+
+	adc_sched_nr_of_sensors = 0;
+	adc_sched_pending = 0;
+	adc_sched_busy = 0;
+	adc_sched_held = false;
+	adc_sched_done = 0;
+
+	adc_sched_work.fn = adc_sched_work_handler;
+	adc_sched_work.priority = CONFIG_ADC_SCHED_WORK_PRIORITY;
+
+	/* The clock is only kept running while sweeps are in flight */
+	adc_enable(&ADC_SCHED_ADC);
+	adc_disable_clock(&ADC_SCHED_ADC);
+	adc_sched_clocked = false;
+
+	adc_sched_clock_notifier.fn = adc_sched_clock_handler;
+	clock_scale_register(&adc_sched_clock_notifier);
+}
+
+/**
+ * \brief Register a sensor with the scheduler
+ *
+ * The sensor is due on the first tick after registration.
+ *
+ * \param sensor the sensor configuration, copied by the scheduler
+ * \param id where to store the id of the sensor
+ *
+ * \retval STATUS_OK on success
+ * \retval ERR_NO_MEMORY if all sensor slots are taken
+ */
+status_code_t adc_sched_register(const struct adc_sched_sensor *sensor,
+		uint8_t *id)
+{
+	uint8_t i = adc_sched_nr_of_sensors;
+
+	Assert(sensor->callback);
+
+	if (i >= CONFIG_ADC_SCHED_MAX_SENSORS) {
+		return ERR_NO_MEMORY;
+	}
+
+	adc_sched_sensors[i] = *sensor;
+	adcch_set_input(&adc_sched_ch_conf[i], sensor->pos, sensor->neg,
+			sensor->gain);
+	adc_sched_countdown[i] = 0;
+	adc_sched_nr_of_sensors = i + 1;
+
+	*id = i;
+	return STATUS_OK;
+}
+
+/**
+ * \brief Change the sample period of a sensor
+ *
+ * \param id the sensor id
+ * \param period sample period in ticks, 0 to only sample on request
+ */
+void adc_sched_set_period(uint8_t id, uint16_t period)
+{
+	Assert(id < adc_sched_nr_of_sensors);
+	adc_sched_sensors[id].period = period;
+	if (adc_sched_countdown[id] > period) {
+		adc_sched_countdown[id] = period;
+	}
+}
+
+/**
+ * \brief Change the gain stage and reference of a sensor
+ *
+ * Takes effect from the next sweep the sensor is packed into; a conversion
+ * already in flight completes with the old setting. Safe to call from the
+ * sensor callback.
+ *
+ * \param id the sensor id
+ * \param neg negative input, see adcch_set_input()
+ * \param gain gain factor, see adcch_set_input()
+ * \param ref reference to convert against
+ */
+void adc_sched_set_input(uint8_t id, enum adcch_negative_input neg,
+		uint8_t gain, enum adc_reference ref)
+{
+	struct adc_sched_sensor *sensor = &adc_sched_sensors[id];
+	irqflags_t flags;
+
+	Assert(id < adc_sched_nr_of_sensors);
+
+	flags = cpu_irq_save();
+	sensor->neg = neg;
+	sensor->gain = gain;
+	sensor->ref = ref;
+	adcch_set_input(&adc_sched_ch_conf[id], sensor->pos, neg, gain);
+	/* Force the channel registers to be rewritten on the next sweep */
+	for (uint8_t ch = 0; ch < ADC_SCHED_NR_OF_CHANNELS; ch++) {
+		if (adc_sched_ch_sensor[ch] == id) {
+			adc_sched_ch_sensor[ch] = 0xff;
+		}
+	}
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Request a conversion of a sensor as soon as possible
+ *
+ * The sensor is queued for the next sweep, which starts right away if the ADC
+ * is idle. Safe to call from the sensor callback.
+ *
+ * \param id the sensor id
+ */
+void adc_sched_request(uint8_t id)
+{
+	irqflags_t flags;
+
+	Assert(id < adc_sched_nr_of_sensors);
+
+	flags = cpu_irq_save();
+	adc_sched_pending |= 1 << id;
+	adc_sched_start_sweep();
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Advance the scheduler by one tick
+ *
+ * Every sensor whose period has elapsed is queued, and the due sensors are
+ * started together in as few sweeps as their references allow.
+ */
+void adc_sched_tick(void)
+{
+	uint8_t due = 0;
+	irqflags_t flags;
+
+	for (uint8_t i = 0; i < adc_sched_nr_of_sensors; i++) {
+		if (!adc_sched_sensors[i].period) {
+			continue;
+		}
+		if (adc_sched_countdown[i] == 0) {
+			due |= 1 << i;
+			adc_sched_countdown[i] = adc_sched_sensors[i].period;
+		}
+		adc_sched_countdown[i]--;
+	}
+
+	if (due) {
+		flags = cpu_irq_save();
+		adc_sched_pending |= due;
+		adc_sched_start_sweep();
+		cpu_irq_restore(flags);
+	}
+}
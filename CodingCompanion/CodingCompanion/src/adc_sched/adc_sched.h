@@ -0,0 +1,73 @@
+/**
+ * \file
+ *
+ * \brief ADC sampling scheduler
+ *
+ * Lets every logical sensor register its input, reference, gain and sample
+ * period, and packs the due sensors onto the four ADCA channels. Sensors
+ * sharing a reference are converted together in one sweep; sensors that do not
+ * fit, or need another reference, follow in the next sweep as soon as the
+ * current one completes.
+ *
+ * Periods are given in scheduler ticks, i.e. calls to adc_sched_tick(). The
+ * clock of the ADC only runs while a sweep is in flight.
+ *
+ * The ADC interrupt only stores the result and starts the next sweep. The
+ * sensor callbacks are deferred to the work queue of priority
+ * CONFIG_ADC_SCHED_WORK_PRIORITY, see work.h.
+ */
+#ifndef ADC_SCHED_H_INCLUDED
+#define ADC_SCHED_H_INCLUDED
+
+#include "adc.h"
+#include "status_codes.h"
+#include <work/work.h>
+
+//! Maximum number of sensors that can be registered
+#ifndef CONFIG_ADC_SCHED_MAX_SENSORS
+#  define CONFIG_ADC_SCHED_MAX_SENSORS 8
+#endif
+
+//! Work queue the sensor callbacks run from
+#ifndef CONFIG_ADC_SCHED_WORK_PRIORITY
+#  define CONFIG_ADC_SCHED_WORK_PRIORITY WORK_PRIORITY_HIGH
+#endif
+
+//! Module the scheduler runs on
+#define ADC_SCHED_ADC        ADCA
+//! Number of hardware channels available for packing
+#define ADC_SCHED_NR_OF_CHANNELS 4
+//! ADC clock, kept across clock switches
+#define ADC_SCHED_CLOCK_HZ   125000UL
+
+/**
+ * \brief Callback for a completed conversion
+ *
+ * Called from the main context with the id returned by adc_sched_register().
+ * Only the last result is kept, so if a sensor completes again before its
+ * callback runs, the earlier result is dropped.
+ */
+typedef void (*adc_sched_callback_t)(uint8_t sensor, adc_result_t result);
+
+//! Sensor registration
+struct adc_sched_sensor {
+	enum adcch_positive_input pos;
+	enum adcch_negative_input neg;
+	//! Gain, as accepted by adcch_set_input()
+	uint8_t gain;
+	enum adc_reference ref;
+	//! Sample period in ticks, 0 to only sample on request
+	uint16_t period;
+	adc_sched_callback_t callback;
+};
+
+void adc_sched_init(void);
+status_code_t adc_sched_register(const struct adc_sched_sensor *sensor,
+		uint8_t *id);
+void adc_sched_set_period(uint8_t id, uint16_t period);
+void adc_sched_set_input(uint8_t id, enum adcch_negative_input neg,
+		uint8_t gain, enum adc_reference ref);
+void adc_sched_request(uint8_t id);
+void adc_sched_tick(void);
+
+#endif /* ADC_SCHED_H_INCLUDED */
@@ -43,101 +43,191 @@
 
 #include "adc.h"
 #include "adc_sensors.h"
+#include <adc_sched/adc_sched.h>
+#include <lockfree/lockfree.h>
+#include <trace/trace.h>
 
 #define NTC_SENSOR_MAX_SAMPLES   4
 #define LIGHT_SENSOR_MAX_SAMPLES 4
 
-//! bool to hold the data ready flag
-bool ntc_sensor_data_ready = false;
-bool light_sensor_data_ready = false;
-adc_result_t ntc_sensor_sample = 0;
-adc_result_t light_sensor_sample = 0;
+//! Step to a less sensitive range above this many counts (95 % of full scale)
+#define LIGHT_RANGE_HIGH 1945
+//! Step to a more sensitive range if the reading would stay below 85 % there
+#define LIGHT_RANGE_LOW  1740
+
+/**
+ * \brief Light sensor measurement range
+ *
+ * Ranges are ordered from least to most sensitive. \a scale is the full scale
+ * of the range relative to the first one, times 2^16, and converts counts to
+ * the light level with LIGHT_LEVEL_FRAC_BITS fractional bits.
+ */
+struct light_range {
+	enum adc_reference ref;
+	enum adcch_negative_input neg;
+	uint8_t gain;
+	uint32_t scale;
+};
+
+static const struct light_range light_ranges[] = {
+	/* 2.06 V full scale, single-ended */
+	{ ADC_REF_VCC,     ADCCH_NEG_NONE,    1, 65536 },
+	/* 1.00 V full scale, single-ended */
+	{ ADC_REF_BANDGAP, ADCCH_NEG_NONE,    1, 31775 },
+	/* 500 mV down to 62.5 mV full scale through the gain stage */
+	{ ADC_REF_BANDGAP, ADCCH_NEG_PAD_GND, 2, 15888 },
+	{ ADC_REF_BANDGAP, ADCCH_NEG_PAD_GND, 4, 7944 },
+	{ ADC_REF_BANDGAP, ADCCH_NEG_PAD_GND, 8, 3972 },
+	{ ADC_REF_BANDGAP, ADCCH_NEG_PAD_GND, 16, 1986 },
+};
+
+#define LIGHT_NR_OF_RANGES (sizeof(light_ranges) / sizeof(light_ranges[0]))
+
+#define NTC_SENSOR_DATA_READY   (1 << 0)
+#define LIGHT_SENSOR_DATA_READY (1 << 1)
+
+//! data ready flags, set by the ADC callback and consumed by the readers
+static volatile uint8_t adc_sensors_data_ready;
+//! latest averaged samples, published by the ADC callback
+static struct lf_snapshot16 ntc_sensor_sample;
+static struct lf_snapshot16 light_sensor_sample;
+static struct lf_snapshot16 light_sensor_level;
+//! current light sensor range, index into light_ranges
+static uint8_t light_sensor_range = 0;
+//! scheduler ids of the sensors
+static uint8_t ntc_sensor_id;
+static uint8_t light_sensor_id;
+
+/**
+ * \brief Call this to schedule a ADC reading of the temperature sensor
+ *
+ * Calling this will trigger the ADC to perform a reading of the on board NTC,
+ * the ADC will automatically recall this function the number of times
+ * specified for averaging.
+ */
+void ntc_measure(void)
+{
+	adc_sched_request(ntc_sensor_id);
+}
+
+void lightsensor_measure(void)
+{
+	adc_sched_request(light_sensor_id);
+}
 
 /**
  * \brief Check of there is NTC data ready to be read
  *
  * When data is ready to be read this function will return true, and assume
  * that the data is going to be read so it sets the ready flag to false.
+ * The flag is tested and cleared in one atomic instruction, so interrupts stay
+ * enabled.
  *
  * \retval true if the NTC value is ready to be read
  * \retval false if data is not ready yet
  */
 bool ntc_data_is_ready(void)
 {
-	irqflags_t irqflags;
-	/* We will need to save and turn of global interrupts to make sure that we
-	read the latest NTC value and not the next one if a conversation finish
-	before one have time read the data. */
-	irqflags = cpu_irq_save();
-	if (ntc_sensor_data_ready) {
-		ntc_sensor_data_ready = false;
-		cpu_irq_restore(irqflags);
-		return true;
-	} else {
-		cpu_irq_restore(irqflags);
-		return false;
-	}
+	return lf_flags_fetch_and_clear(&adc_sensors_data_ready,
+			NTC_SENSOR_DATA_READY);
 }
 
 bool lightsensor_data_is_ready(void)
 {
-	irqflags_t irqflags;
-	/* We will need to save and turn of global interrupts to make sure that we
-	read the latest NTC value and not the next one if a conversation finish
-	before one have time read the data. */
-	irqflags = cpu_irq_save();
-	if (light_sensor_data_ready) {
-		light_sensor_data_ready = false;
-		cpu_irq_restore(irqflags);
-		return true;
+	return lf_flags_fetch_and_clear(&adc_sensors_data_ready,
+			LIGHT_SENSOR_DATA_READY);
+}
+
+/**
+ * \brief Pick the light sensor range for the next conversion
+ *
+ * Steps one range less sensitive when the reading is close to full scale, and
+ * one range more sensitive when the reading would still fit there with some
+ * headroom. The gap between the two thresholds gives hysteresis, so the range
+ * does not toggle on a steady input.
+ *
+ * \param result the last conversion in the current range
+ *
+ * \retval true if the range was changed
+ */
+static bool lightsensor_autorange(adc_result_t result)
+{
+	uint8_t range = light_sensor_range;
+	int16_t counts = result;
+
+	if (counts >= LIGHT_RANGE_HIGH && range > 0) {
+		range--;
+	} else if (range < LIGHT_NR_OF_RANGES - 1 && (uint32_t)(counts < 0 ? 0
+			: counts) * light_ranges[range].scale
+			< (uint32_t)LIGHT_RANGE_LOW * light_ranges[range + 1].scale) {
+		range++;
 	} else {
-		cpu_irq_restore(irqflags);
 		return false;
 	}
+
+	light_sensor_range = range;
+	adc_sched_set_input(light_sensor_id, light_ranges[range].neg,
+			light_ranges[range].gain, light_ranges[range].ref);
+	return true;
 }
 
 /**
  * \brief Callback for the ADC conversion complete
  *
- * The ADC module will call this function on a conversion complete.
+ * The ADC scheduler will call this function on a conversion complete.
  *
- * \param adc the ADC from which the interrupt came
- * \param ch_mask the ch_mask that produced the interrupt
+ * \param sensor the scheduler id of the sensor that was converted
  * \param result the result from the ADC
  */
-void adc_handler(ADC_t *adc, uint8_t ch_mask, adc_result_t result)
+void adc_handler(uint8_t sensor, adc_result_t result)
 {
 	static uint8_t light_sensor_samples = 0;
 	static uint8_t ntc_sensor_samples = 0;
+	static adc_result_t light_sensor_average;
+	static adc_result_t ntc_sensor_average;
+
+	result = trace_adc(sensor, result);
 
-	// Lightsensor on channel 0 , NTC on channel 1
-	if (ch_mask == ADC_CH0) {
+	if (sensor == light_sensor_id) {
+		if (lightsensor_autorange(result)) {
+			/* Samples from different ranges can't be averaged, start
+			over in the new range. */
+			light_sensor_samples = 0;
+			lightsensor_measure();
+			return;
+		}
 		light_sensor_samples++;
 		if (light_sensor_samples == 1) {
-			light_sensor_sample = result;
-			light_sensor_data_ready = false;
+			light_sensor_average = result;
+			lf_flags_clear(&adc_sensors_data_ready, LIGHT_SENSOR_DATA_READY);
 		} else {
-			light_sensor_sample += result;
-			light_sensor_sample >>= 1;
+			light_sensor_average += result;
+			light_sensor_average >>= 1;
 		}
 		if (light_sensor_samples == LIGHT_SENSOR_MAX_SAMPLES) {
 			light_sensor_samples = 0;
-			light_sensor_data_ready = true;
+			lf_snapshot16_write(&light_sensor_sample, light_sensor_average);
+			lf_snapshot16_write(&light_sensor_level,
+					((uint32_t)(light_sensor_average < 0 ? 0
+					: light_sensor_average)
+					* light_ranges[light_sensor_range].scale) >> 12);
+			lf_flags_set(&adc_sensors_data_ready, LIGHT_SENSOR_DATA_READY);
 		} else {
 			lightsensor_measure();
 		}
-	} else if (ch_mask == ADC_CH1) {
+	} else if (sensor == ntc_sensor_id) {
 		ntc_sensor_samples++;
 		if (ntc_sensor_samples == 1) {
-			ntc_sensor_sample = result;
-			ntc_sensor_data_ready = false;
+			ntc_sensor_average = result;
+			lf_flags_clear(&adc_sensors_data_ready, NTC_SENSOR_DATA_READY);
 		} else {
-			ntc_sensor_sample += result;
-			ntc_sensor_sample >>= 1;
+			ntc_sensor_average += result;
+			ntc_sensor_average >>= 1;
 		}
 		if (ntc_sensor_samples == NTC_SENSOR_MAX_SAMPLES) {
 			ntc_sensor_samples = 0;
-			ntc_sensor_data_ready = true;
+			lf_snapshot16_write(&ntc_sensor_sample, ntc_sensor_average);
+			lf_flags_set(&adc_sensors_data_ready, NTC_SENSOR_DATA_READY);
 		} else {
 			ntc_measure();
 		}
@@ -152,46 +242,26 @@ void adc_handler(ADC_t *adc, uint8_t ch_mask, adc_result_t result)
  */
 void adc_sensors_init(void)
 {
-	struct adc_config adc_conf;
-	struct adc_channel_config adc_ch_conf;
-
-	/* Clear the ADC configuration structs */
-	adc_read_configuration(&ADCA, &adc_conf);
-	adcch_read_configuration(&ADCA, ADC_CH0, &adc_ch_conf);
-
-	/* configure the ADCA module:
-	- signed, 12-bit resolution
-	- VCC / 1.6 reference
-	- 31 kHz max clock rate
-	- manual conversion triggering
-	- callback function
-	*/
-	adc_set_conversion_parameters(&adc_conf, ADC_SIGN_ON, ADC_RES_12,
-			ADC_REF_VCC);
-	adc_set_clock_rate(&adc_conf, 125000UL);
-	adc_set_conversion_trigger(&adc_conf, ADC_TRIG_MANUAL, 1, 0);
-	adc_write_configuration(&ADCA, &adc_conf);
-	adc_set_callback(&ADCA, &adc_handler);
-
-	/* Configure ADC A channel 0 (lightsensor):
-	 * - single-ended measurement
-	 * - interrupt flag set on completed conversion
-	 * - interrupts enabled
-	 */
-	adcch_set_input(&adc_ch_conf, ADCCH_POS_PIN0, ADCCH_NEG_NONE, 1);
-	adcch_set_interrupt_mode(&adc_ch_conf, ADCCH_MODE_COMPLETE);
-	adcch_enable_interrupt(&adc_ch_conf);
-	adcch_write_configuration(&ADCA, ADC_CH0, &adc_ch_conf);
+	struct adc_sched_sensor sensor;
+
+	adc_sched_init();
 
-	/* Configure ADC A channel 1 (NTC sensor):
+	/* Light sensor and NTC:
 	 * - single-ended measurement
-	 * - interrupt flag set on completed conversion
-	 * - interrupts enabled
+	 * - VCC / 1.6 reference
+	 * - light sampled every tick, the NTC every NTC_SENSOR_PERIOD ticks
 	 */
-	adcch_set_input(&adc_ch_conf, ADCCH_POS_PIN1, ADCCH_NEG_NONE, 1);
-	adcch_write_configuration(&ADCA, ADC_CH1, &adc_ch_conf);
+	sensor.pos = ADCCH_POS_PIN0;
+	sensor.neg = ADCCH_NEG_NONE;
+	sensor.gain = 1;
+	sensor.ref = ADC_REF_VCC;
+	sensor.period = LIGHT_SENSOR_PERIOD;
+	sensor.callback = adc_handler;
+	adc_sched_register(&sensor, &light_sensor_id);
 
-	adc_enable(&ADCA);
+	sensor.pos = ADCCH_POS_PIN1;
+	sensor.period = NTC_SENSOR_PERIOD;
+	adc_sched_register(&sensor, &ntc_sensor_id);
 }
 
 /**
@@ -204,7 +274,7 @@ void adc_sensors_init(void)
  */
 int16_t ntc_get_raw_value(void)
 {
-	return ntc_sensor_sample;
+	return lf_snapshot16_read(&ntc_sensor_sample);
 }
 
 /**
@@ -221,10 +291,11 @@ int16_t ntc_get_raw_value(void)
 int8_t ntc_get_temperature(void)
 {
 	int8_t retval = 0;
-	float ntc_sample = ntc_sensor_sample;
-	if (ntc_sensor_sample > 697) {
+	int16_t ntc_raw = ntc_get_raw_value();
+	float ntc_sample = ntc_raw;
+	if (ntc_raw > 697) {
 		retval = (int8_t)((-0.0295 * ntc_sample) + 40.5);
-	} if (ntc_sensor_sample > 420) {
+	} if (ntc_raw > 420) {
 		retval = (int8_t)((-0.0474 * ntc_sample) + 53.3);
 	} else {
 		retval = (int8_t)((-0.0777 * ntc_sample) + 65.1);
@@ -242,6 +313,30 @@ int8_t ntc_get_temperature(void)
  */
 int16_t lightsensor_get_raw_value(void)
 {
-	return light_sensor_sample;
+	return lf_snapshot16_read(&light_sensor_sample);
+}
+
+/**
+ * \brief Read the auto-ranged light level
+ *
+ * The raw value is normalized from the range it was measured in to a single
+ * scale, so readings compare across ranges.
+ *
+ * \retval the light level in counts of the least sensitive range, with
+ * LIGHT_LEVEL_FRAC_BITS fractional bits
+ */
+uint16_t lightsensor_get_level(void)
+{
+	return lf_snapshot16_read(&light_sensor_level);
+}
+
+/**
+ * \brief Read the current light sensor range
+ *
+ * \retval 0 for the least sensitive range, higher for more sensitive ones
+ */
+uint8_t lightsensor_get_range(void)
+{
+	return light_sensor_range;
 }
 
@@ -45,28 +45,29 @@
 
 #include "adc.h"
 
+//! Scheduler ticks between light sensor readings
+#define LIGHT_SENSOR_PERIOD 1
+//! Scheduler ticks between NTC readings, the room temperature changes slowly
+#define NTC_SENSOR_PERIOD   8
+
 /**
- * \brief Call this to schedule a ADC reading of the temperature sensor
+ * \brief Fractional bits of the light level
  *
- * Calling this will trigger the ADC to perform a reading of the on board NTC,
- * the ADC will automatically recall this function the number of times
- * specified for averaging.
+ * The light level is given in counts of the least sensitive range (VCC / 1.6
+ * reference, unity gain), with this many fractional bits for readings taken in
+ * the more sensitive ranges.
  */
-static inline void ntc_measure(void)
-{
-	adc_start_conversion(&ADCA, ADC_CH1);
-}
-
-static inline void lightsensor_measure(void)
-{
-	adc_start_conversion(&ADCA, ADC_CH0);
-}
+#define LIGHT_LEVEL_FRAC_BITS 4
 
-void adc_handler(ADC_t *adc, uint8_t channel, adc_result_t result);
+void ntc_measure(void);
+void lightsensor_measure(void);
+void adc_handler(uint8_t sensor, adc_result_t result);
 void adc_sensors_init(void);
 int16_t ntc_get_raw_value(void);
 int8_t ntc_get_temperature(void);
 int16_t lightsensor_get_raw_value(void);
+uint16_t lightsensor_get_level(void);
+uint8_t lightsensor_get_range(void);
 bool ntc_data_is_ready(void);
 bool lightsensor_data_is_ready(void);
 
@@ -0,0 +1,85 @@
+/**
+ * \file
+ *
+ * \brief Boot milestone timing
+ *
+ */
+#include <asf.h>
+#include <systime/systime.h>
+#include <console/console.h>
+#include "boot.h"
+
+//! \internal Name of each milestone on the console
+static const char *const boot_stage_name[BOOT_NR_OF_STAGES] = {
+	"display", "sched", "sample", "rtc", "clock",
+};
+
+//! \internal Microseconds from the start of the clock to each milestone
+static uint32_t boot_time[BOOT_NR_OF_STAGES];
+
+/**
+ * \brief Initialize the milestones as not reached
+ *
+ * \note Stamps on the monotonic clock, so systime_init() must be called
+ * first.
+ */
+void boot_init(void)
+{
+	for (uint8_t i = 0; i < BOOT_NR_OF_STAGES; i++) {
+		boot_time[i] = BOOT_NOT_REACHED;
+	}
+#ifdef CONFIG_BOOT_CONSOLE
+	console_init();
+	console_register_command('b', boot_dump);
+#endif
+}
+
+/**
+ * \brief Stamp a milestone
+ *
+ * Only the first call for each milestone counts, so it is cheap to call on
+ * every pass through the code that reaches it.
+ *
+ * \param stage the milestone reached
+ */
+void boot_mark(enum boot_stage stage)
+{
+	Assert(stage < BOOT_NR_OF_STAGES);
+
+	if (boot_time[stage] == BOOT_NOT_REACHED) {
+		boot_time[stage] = systime_now();
+	}
+}
+
+/**
+ * \brief Get the time of a milestone
+ *
+ * \param stage the milestone
+ *
+ * \retval microseconds from the start of the clock to the milestone, or
+ * BOOT_NOT_REACHED
+ */
+uint32_t boot_get_time(enum boot_stage stage)
+{
+	Assert(stage < BOOT_NR_OF_STAGES);
+
+	return boot_time[stage];
+}
+
+/**
+ * \brief Print the milestones on the console
+ *
+ * One line "U <stage> <us>" per milestone reached, with its time in
+ * microseconds, then "U end". "B" is taken by the button records of a
+ * trace capture.
+ */
+void boot_dump(void)
+{
+	for (uint8_t i = 0; i < BOOT_NR_OF_STAGES; i++) {
+		if (boot_time[i] != BOOT_NOT_REACHED) {
+			console_printf("U %s %lu\r\n", boot_stage_name[i],
+					boot_time[i]);
+		}
+	}
+	console_puts("U end\r\n");
+}
@@ -0,0 +1,43 @@
+/**
+ * \file
+ *
+ * \brief Boot milestone timing
+ *
+ * Stamps each milestone of the bring-up on the monotonic clock the first
+ * time it is reached, so the time from power-up to the first sensor sample
+ * can be read back. Times count from systime_init(), which is the first
+ * thing started after the system clock.
+ *
+ * With CONFIG_BOOT_CONSOLE the milestones are printed on the console with
+ * the 'b' command, see console_poll().
+ */
+#ifndef BOOT_H_INCLUDED
+#define BOOT_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_boot.h>
+
+//! Boot milestones
+enum boot_stage {
+	//! Display cleared and ready to draw on
+	BOOT_STAGE_DISPLAY,
+	//! Scheduler running
+	BOOT_STAGE_SCHED,
+	//! First sensor sample read
+	BOOT_STAGE_SAMPLE,
+	//! RTC crystal started and counting
+	BOOT_STAGE_RTC,
+	//! System clock verified against the RTC
+	BOOT_STAGE_CLOCK,
+	BOOT_NR_OF_STAGES,
+};
+
+//! Time of a milestone that has not been reached
+#define BOOT_NOT_REACHED UINT32_MAX
+
+void boot_init(void);
+void boot_mark(enum boot_stage stage);
+uint32_t boot_get_time(enum boot_stage stage);
+void boot_dump(void);
+
+#endif /* BOOT_H_INCLUDED */
@@ -0,0 +1,323 @@
+/**
+ * \file
+ *
+ * \brief Interrupt-driven button events
+ *
+ */
+#include <asf.h>
+#include <lockfree/lockfree.h>
+#include <soft_timer/soft_timer.h>
+#include <trace/trace.h>
+#include <sleep_stats/sleep_stats.h>
+#include "button.h"
+
+//! \internal Pin of each button
+static const ioport_pin_t button_pins[] = CONFIG_BUTTON_PINS;
+
+//! \internal Number of buttons
+#define BUTTON_NR_OF_BUTTONS (sizeof(button_pins) / sizeof(button_pins[0]))
+
+//! \internal Timer delays of conf_button.h, in timer ticks
+#define BUTTON_DEBOUNCE_TICKS    SOFT_TIMER_MS(CONFIG_BUTTON_DEBOUNCE_MS)
+#define BUTTON_LONG_PRESS_TICKS  SOFT_TIMER_MS(CONFIG_BUTTON_LONG_PRESS_MS)
+#define BUTTON_REPEAT_TICKS      SOFT_TIMER_MS(CONFIG_BUTTON_REPEAT_MS)
+
+//! \internal Events waiting for the main context
+static struct lf_ring button_queue;
+static struct button_event button_queue_buf[CONFIG_BUTTON_QUEUE_SIZE];
+
+//! \internal Debounced state, bit n set while button n is pressed
+static volatile uint8_t button_pressed;
+//! \internal Buttons with a long press or repeat to come
+static uint8_t button_holding;
+//! \internal Buttons that have reported their long press
+static uint8_t button_long;
+//! \internal Timer tick of the next long press or repeat of each button
+static uint32_t button_hold_at[BUTTON_MAX_BUTTONS];
+//! \internal Time of the first edge since the levels were last sampled
+static uint32_t button_edge_time;
+
+static struct soft_timer button_debounce_timer;
+static struct soft_timer button_hold_timer;
+
+/**
+ * \internal
+ * \brief Queue an event
+ *
+ * Only called from the timer callbacks, which never interrupt each other, so
+ * the queue has a single producer. An event is dropped if the queue is full.
+ */
+static void button_push(uint8_t button, enum button_event_type type,
+		uint32_t time)
+{
+	struct button_event event = {
+		.time = time,
+		.button = button,
+		.type = type,
+	};
+
+	lf_ring_push(&button_queue, &event);
+}
+
+#ifndef CONFIG_TRACE_REPLAY
+/**
+ * \internal
+ * \brief Set the level of the pin change interrupts of the buttons
+ *
+ * When the interrupts are enabled, pending changes are cleared first; the
+ * caller samples the levels right after, which covers them.
+ */
+static void button_set_int_level(PORT_INT0LVL_t level)
+{
+	for (uint8_t i = 0; i < BUTTON_NR_OF_BUTTONS; i++) {
+		PORT_t *port = arch_ioport_pin_to_base(button_pins[i]);
+
+		if (level != PORT_INT0LVL_OFF_gc) {
+			port->INTFLAGS = PORT_INT0IF_bm;
+		}
+		port->INTCTRL = (port->INTCTRL & ~PORT_INT0LVL_gm) | level;
+	}
+}
+
+/**
+ * \internal
+ * \brief Handle an edge on any button pin
+ *
+ * Masks the pin changes until the debounce timer has sampled the levels, so
+ * a bouncing contact costs one interrupt.
+ */
+static void button_pin_change_handler(void)
+{
+	sleep_stats_wakeup(SLEEP_STATS_BUTTON);
+	button_set_int_level(PORT_INT0LVL_OFF_gc);
+	button_edge_time = systime_now();
+	soft_timer_start(&button_debounce_timer, BUTTON_DEBOUNCE_TICKS, 0);
+}
+
+/**
+ * \internal
+ * \brief Pin change interrupts of the ports in conf_button.h
+ *
+ * @{
+ */
+#ifdef CONFIG_BUTTON_PORTA
+ISR(PORTA_INT0_vect)
+{
+	button_pin_change_handler();
+}
+#endif
+#ifdef CONFIG_BUTTON_PORTB
+ISR(PORTB_INT0_vect)
+{
+	button_pin_change_handler();
+}
+#endif
+#ifdef CONFIG_BUTTON_PORTC
+ISR(PORTC_INT0_vect)
+{
+	button_pin_change_handler();
+}
+#endif
+#ifdef CONFIG_BUTTON_PORTD
+ISR(PORTD_INT0_vect)
+{
+	button_pin_change_handler();
+}
+#endif
+#ifdef CONFIG_BUTTON_PORTE
+ISR(PORTE_INT0_vect)
+{
+	button_pin_change_handler();
+}
+#endif
+#ifdef CONFIG_BUTTON_PORTF
+ISR(PORTF_INT0_vect)
+{
+	button_pin_change_handler();
+}
+#endif
+#ifdef CONFIG_BUTTON_PORTR
+ISR(PORTR_INT0_vect)
+{
+	button_pin_change_handler();
+}
+#endif
+//! @}
+
+/**
+ * \internal
+ * \brief Listen for edges again after the levels are sampled
+ */
+static inline void button_listen(void)
+{
+	button_set_int_level(PORT_INT0LVL_LO_gc);
+}
+#else
+static inline void button_listen(void)
+{
+}
+#endif
+
+/**
+ * \internal
+ * \brief Set the hold timer for the nearest long press or repeat
+ */
+static void button_hold_arm(void)
+{
+	uint32_t now = soft_timer_now();
+	int32_t delay = INT32_MAX;
+
+	if (!button_holding) {
+		soft_timer_cancel(&button_hold_timer);
+		return;
+	}
+	for (uint8_t i = 0; i < BUTTON_NR_OF_BUTTONS; i++) {
+		if ((button_holding & (1 << i))
+				&& (int32_t)(button_hold_at[i] - now) < delay) {
+			delay = button_hold_at[i] - now;
+		}
+	}
+	soft_timer_start(&button_hold_timer, delay > 0 ? delay : 0, 0);
+}
+
+/**
+ * \internal
+ * \brief Callback for the debounce timer
+ *
+ * Samples the settled levels and reports the buttons that changed, time
+ * stamped with the edge that started the debounce.
+ */
+static void button_debounce_handler(void)
+{
+	uint8_t pressed = 0;
+	uint8_t changed;
+
+	button_listen();
+#ifdef CONFIG_TRACE_REPLAY
+	button_edge_time = systime_now();
+#endif
+
+	for (uint8_t i = 0; i < BUTTON_NR_OF_BUTTONS; i++) {
+		if (!trace_button(i, ioport_get_pin_level(button_pins[i]))) {
+			pressed |= 1 << i;
+		}
+	}
+	changed = pressed ^ button_pressed;
+	button_pressed = pressed;
+	if (!changed) {
+		return;
+	}
+
+	for (uint8_t i = 0; i < BUTTON_NR_OF_BUTTONS; i++) {
+		uint8_t mask = 1 << i;
+
+		if (!(changed & mask)) {
+			continue;
+		}
+		if (pressed & mask) {
+			button_push(i, BUTTON_EVENT_PRESS, button_edge_time);
+			button_hold_at[i] = soft_timer_now() + BUTTON_LONG_PRESS_TICKS;
+			button_holding |= mask;
+			button_long &= ~mask;
+		} else {
+			button_push(i, BUTTON_EVENT_RELEASE, button_edge_time);
+			button_holding &= ~mask;
+		}
+	}
+	button_hold_arm();
+}
+
+/**
+ * \internal
+ * \brief Callback for the hold timer
+ *
+ * Reports a long press for each button held long enough, then repeats at
+ * the repeat interval for as long as it stays held.
+ */
+static void button_hold_handler(void)
+{
+	uint32_t now = soft_timer_now();
+
+	for (uint8_t i = 0; i < BUTTON_NR_OF_BUTTONS; i++) {
+		uint8_t mask = 1 << i;
+
+		if (!(button_holding & mask)
+				|| (int32_t)(button_hold_at[i] - now) > 0) {
+			continue;
+		}
+		if (button_long & mask) {
+			button_push(i, BUTTON_EVENT_REPEAT, systime_now());
+		} else {
+			button_push(i, BUTTON_EVENT_LONG_PRESS, systime_now());
+			button_long |= mask;
+		}
+		if (BUTTON_REPEAT_TICKS) {
+			button_hold_at[i] = now + BUTTON_REPEAT_TICKS;
+		} else {
+			button_holding &= ~mask;
+		}
+	}
+	button_hold_arm();
+}
+
+/**
+ * \brief Start watching the buttons
+ *
+ * Switches the button pins to sense both edges. In replay mode the replayed
+ * levels change without any edge on the pins, so they are polled at the
+ * debounce interval instead.
+ *
+ * \note Runs on the software timers, so soft_timer_init() must be called
+ * first.
+ */
+void button_init(void)
+{
+	Assert(BUTTON_NR_OF_BUTTONS <= BUTTON_MAX_BUTTONS);
+
+	lf_ring_init(&button_queue, button_queue_buf,
+			sizeof(button_queue_buf[0]), CONFIG_BUTTON_QUEUE_SIZE);
+	/* Buttons already held at start are reported as pressed */
+	button_pressed = 0;
+	button_holding = 0;
+	button_long = 0;
+	button_edge_time = systime_now();
+	button_debounce_timer.callback = button_debounce_handler;
+	button_hold_timer.callback = button_hold_handler;
+
+#ifdef CONFIG_TRACE_REPLAY
+	soft_timer_start(&button_debounce_timer, BUTTON_DEBOUNCE_TICKS,
+			BUTTON_DEBOUNCE_TICKS);
+#else
+	for (uint8_t i = 0; i < BUTTON_NR_OF_BUTTONS; i++) {
+		PORT_t *port = arch_ioport_pin_to_base(button_pins[i]);
+
+		ioport_set_pin_sense_mode(button_pins[i], IOPORT_SENSE_BOTHEDGES);
+		port->INT0MASK |= arch_ioport_pin_to_mask(button_pins[i]);
+	}
+	soft_timer_start(&button_debounce_timer, 0, 0);
+#endif
+}
+
+/**
+ * \brief Take the oldest button event
+ *
+ * \param event where to store the event
+ *
+ * \retval true if an event was taken
+ * \retval false if there are no events
+ */
+bool button_get_event(struct button_event *event)
+{
+	return lf_ring_pop(&button_queue, event);
+}
+
+/**
+ * \brief Check whether a button is pressed, after debouncing
+ *
+ * \param button the button number
+ */
+bool button_is_pressed(uint8_t button)
+{
+	Assert(button < BUTTON_NR_OF_BUTTONS);
+	return button_pressed & (1 << button);
+}
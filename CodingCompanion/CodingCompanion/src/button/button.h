@@ -0,0 +1,53 @@
+/**
+ * \file
+ *
+ * \brief Interrupt-driven button events
+ *
+ * The buttons of conf_button.h raise a port interrupt on any edge. The first
+ * edge masks the port interrupts and starts a debounce timer, and when it
+ * expires the settled levels are compared with the last ones to produce
+ * press and release events. Buttons held down produce a long press event
+ * and then repeat events, timed by a second software timer. No timer runs
+ * while no button is bouncing or held, so idle buttons cost nothing.
+ *
+ * Events are queued from interrupt context and taken in the main context
+ * with button_get_event(). Each carries the monotonic clock time of the
+ * edge that caused it, so durations are measured from timestamps rather
+ * than by counting ticks.
+ */
+#ifndef BUTTON_H_INCLUDED
+#define BUTTON_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_button.h>
+
+//! Most buttons the service can handle
+#define BUTTON_MAX_BUTTONS 8
+
+//! Type of a button event
+enum button_event_type {
+	//! The button went down
+	BUTTON_EVENT_PRESS,
+	//! The button went up
+	BUTTON_EVENT_RELEASE,
+	//! The button has been held for CONFIG_BUTTON_LONG_PRESS_MS
+	BUTTON_EVENT_LONG_PRESS,
+	//! The button is still held, every CONFIG_BUTTON_REPEAT_MS
+	BUTTON_EVENT_REPEAT,
+};
+
+//! One button event
+struct button_event {
+	//! Monotonic clock time of the event, see systime_now()
+	uint32_t time;
+	//! Button number, the index in CONFIG_BUTTON_PINS
+	uint8_t button;
+	//! Event type, one of enum button_event_type
+	uint8_t type;
+};
+
+void button_init(void);
+bool button_get_event(struct button_event *event);
+bool button_is_pressed(uint8_t button);
+
+#endif /* BUTTON_H_INCLUDED */
@@ -0,0 +1,283 @@
+/**
+ * \file
+ *
+ * \brief Runtime clock scaling
+ *
+ */
+#include <asf.h>
+#include <systime/systime.h>
+#include <rtc_clock/rtc_clock.h>
+#include "clock_scale.h"
+
+uint32_t clock_scale_main_hz = 2000000UL;
+
+//! \internal Main clock of each profile
+static const uint32_t clock_scale_hz[CLOCK_SCALE_NR_OF_PROFILES] = {
+	2000000UL,
+	2000000UL * CONFIG_CLOCK_SCALE_PLL_MUL,
+	32000000UL,
+};
+
+//! \internal System clock source of each profile
+static const uint8_t clock_scale_source[CLOCK_SCALE_NR_OF_PROFILES] = {
+	SYSCLK_SRC_RC2MHZ,
+	SYSCLK_SRC_PLL,
+	SYSCLK_SRC_RC32MHZ,
+};
+
+//! \internal Measured main clock of each profile, 0 if not measured
+static uint32_t clock_scale_measured_hz[CLOCK_SCALE_NR_OF_PROFILES];
+
+//! \internal Registered notifiers, most recent first
+static struct clock_scale_notifier *clock_scale_notifiers;
+//! \internal Number of locks held on each profile
+static uint8_t clock_scale_locks[CLOCK_SCALE_NR_OF_PROFILES];
+//! \internal Running profile
+static enum clock_scale_profile clock_scale_profile;
+//! \internal Tries taken by the running verification, 0 if none is running
+static uint8_t clock_scale_verify_tries;
+
+/**
+ * \internal
+ * \brief Call every notifier with \a event
+ */
+static void clock_scale_notify(enum clock_scale_event event)
+{
+	struct clock_scale_notifier *notifier;
+
+	for (notifier = clock_scale_notifiers; notifier;
+			notifier = notifier->next) {
+		notifier->fn(event);
+	}
+}
+
+/**
+ * \internal
+ * \brief Start the source of a profile and wait until it can clock the CPU
+ */
+static void clock_scale_start_source(enum clock_scale_profile profile)
+{
+	struct pll_config pll_conf;
+
+	switch (profile) {
+	case CLOCK_SCALE_PLL:
+		pll_config_init(&pll_conf, PLL_SRC_RC2MHZ, 1,
+				CONFIG_CLOCK_SCALE_PLL_MUL);
+		pll_enable(&pll_conf, 0);
+		pll_wait_for_lock(0);
+		break;
+	case CLOCK_SCALE_RC32M:
+		osc_enable(CONFIG_OSC_AUTOCAL_RC32MHZ_REF_OSC);
+		osc_wait_ready(CONFIG_OSC_AUTOCAL_RC32MHZ_REF_OSC);
+		osc_enable(OSC_ID_RC32MHZ);
+		osc_wait_ready(OSC_ID_RC32MHZ);
+		osc_enable_autocalibration(OSC_ID_RC32MHZ,
+				CONFIG_OSC_AUTOCAL_RC32MHZ_REF_OSC);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * \internal
+ * \brief Stop the source of a profile that is no longer running
+ *
+ * The 2 MHz oscillator and the DFLL reference are left running, the PLL
+ * runs from the first and the RTC may run from the second. The calibration
+ * the DFLL reached is kept while the 32 MHz oscillator is off, so it starts
+ * calibrated on the next switch.
+ */
+static void clock_scale_stop_source(enum clock_scale_profile profile)
+{
+	switch (profile) {
+	case CLOCK_SCALE_PLL:
+		pll_disable(0);
+		break;
+	case CLOCK_SCALE_RC32M:
+		osc_disable_autocalibration(OSC_ID_RC32MHZ);
+		osc_disable(OSC_ID_RC32MHZ);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * \internal
+ * \brief Switch to the fastest locked profile
+ *
+ * Drivers are notified on both sides of the switch, and the source of the
+ * profile that was running is stopped afterwards.
+ */
+static void clock_scale_update(void)
+{
+	enum clock_scale_profile profile = CLOCK_SCALE_NR_OF_PROFILES - 1;
+	enum clock_scale_profile old = clock_scale_profile;
+	irqflags_t flags;
+
+	while (profile > CLOCK_SCALE_RC2M && !clock_scale_locks[profile]) {
+		profile--;
+	}
+	if (profile == old) {
+		return;
+	}
+
+	clock_scale_start_source(profile);
+	clock_scale_notify(CLOCK_SCALE_PRE_CHANGE);
+
+	flags = cpu_irq_save();
+	sysclk_set_source(clock_scale_source[profile]);
+	clock_scale_main_hz = clock_scale_hz[profile];
+	clock_scale_profile = profile;
+	clock_scale_notify(CLOCK_SCALE_POST_CHANGE);
+	cpu_irq_restore(flags);
+
+	clock_scale_stop_source(old);
+}
+
+/**
+ * \brief Initialize clock scaling
+ *
+ * \note sysclk_init() must have set up the 2 MHz oscillator as the system
+ * clock, which is what conf_clock.h selects.
+ */
+void clock_scale_init(void)
+{
+	Assert(CONFIG_SYSCLK_SOURCE == SYSCLK_SRC_RC2MHZ);
+
+	memset(clock_scale_locks, 0, sizeof(clock_scale_locks));
+	memset(clock_scale_measured_hz, 0, sizeof(clock_scale_measured_hz));
+	clock_scale_profile = CLOCK_SCALE_RC2M;
+	clock_scale_main_hz = clock_scale_hz[CLOCK_SCALE_RC2M];
+	clock_scale_verify_tries = 0;
+}
+
+/**
+ * \brief Register a notifier for clock switches
+ *
+ * \param notifier the notifier, with \a fn set
+ */
+void clock_scale_register(struct clock_scale_notifier *notifier)
+{
+	Assert(notifier->fn);
+
+	notifier->next = clock_scale_notifiers;
+	clock_scale_notifiers = notifier;
+}
+
+/**
+ * \brief Keep the clock at least as fast as a profile
+ *
+ * Switches the clock right away if needed, which waits for the oscillator
+ * of the profile to start. Not to be called from interrupts.
+ *
+ * \param profile the profile
+ */
+void clock_scale_lock(enum clock_scale_profile profile)
+{
+	Assert(profile < CLOCK_SCALE_NR_OF_PROFILES);
+	Assert(clock_scale_locks[profile] < 255);
+
+	clock_scale_locks[profile]++;
+	clock_scale_update();
+}
+
+/**
+ * \brief Release a lock taken with clock_scale_lock()
+ *
+ * The clock drops to the fastest profile still locked. Not to be called
+ * from interrupts.
+ *
+ * \param profile the profile
+ */
+void clock_scale_unlock(enum clock_scale_profile profile)
+{
+	Assert(profile < CLOCK_SCALE_NR_OF_PROFILES);
+	Assert(clock_scale_locks[profile]);
+
+	clock_scale_locks[profile]--;
+	clock_scale_update();
+}
+
+/**
+ * \brief Get the running profile
+ */
+enum clock_scale_profile clock_scale_get_profile(void)
+{
+	return clock_scale_profile;
+}
+
+/**
+ * \brief Verify the DFLL lock of the 32 MHz profile
+ *
+ * Runs the 32 MHz profile and times CONFIG_CLOCK_SCALE_VERIFY_TICKS of the
+ * RTC on the monotonic clock, until the clock is within
+ * CONFIG_CLOCK_SCALE_TOLERANCE_PPM or CONFIG_CLOCK_SCALE_VERIFY_TRIES runs
+ * out. The last measurement is kept either way.
+ *
+ * Never waits for a measurement: the first call starts the verification,
+ * and it is called again, e.g. from a periodic task, until it returns
+ * something else than OPERATION_IN_PROGRESS. The clock stays at 32 MHz
+ * until then. Meant to be run once at startup.
+ *
+ * \note The monotonic clock and the RTC must be running, see systime_init()
+ * and rtc_clock_init().
+ *
+ * \retval OPERATION_IN_PROGRESS if the verification is still running
+ * \retval STATUS_OK if the clock is locked
+ * \retval ERR_TIMEOUT if it stayed out of tolerance
+ */
+status_code_t clock_scale_verify(void)
+{
+	const uint32_t expected = (uint32_t)CONFIG_CLOCK_SCALE_VERIFY_TICKS
+			* SYSTIME_TICKS_PER_SEC / RTC_CLOCK_TICKS_PER_SEC;
+	const uint32_t nominal = clock_scale_hz[CLOCK_SCALE_RC32M];
+	const uint32_t tolerance = nominal / 1000000UL
+			* CONFIG_CLOCK_SCALE_TOLERANCE_PPM;
+	status_code_t status;
+	uint32_t us;
+	uint32_t hz;
+
+	if (!clock_scale_verify_tries) {
+		clock_scale_lock(CLOCK_SCALE_RC32M);
+		clock_scale_verify_tries = 1;
+		rtc_clock_measure_start(CONFIG_CLOCK_SCALE_VERIFY_TICKS);
+		return OPERATION_IN_PROGRESS;
+	}
+	if (!rtc_clock_measure_poll(&us)) {
+		return OPERATION_IN_PROGRESS;
+	}
+
+	/* The monotonic clock counts nominal microseconds, so it runs fast by
+	 * as much as the system clock does */
+	hz = ((uint64_t)nominal * us) / expected;
+	clock_scale_measured_hz[CLOCK_SCALE_RC32M] = hz;
+	if ((hz > nominal - tolerance) && (hz < nominal + tolerance)) {
+		status = STATUS_OK;
+	} else if (clock_scale_verify_tries < CONFIG_CLOCK_SCALE_VERIFY_TRIES) {
+		clock_scale_verify_tries++;
+		rtc_clock_measure_start(CONFIG_CLOCK_SCALE_VERIFY_TICKS);
+		return OPERATION_IN_PROGRESS;
+	} else {
+		status = ERR_TIMEOUT;
+	}
+
+	clock_scale_verify_tries = 0;
+	clock_scale_unlock(CLOCK_SCALE_RC32M);
+
+	return status;
+}
+
+/**
+ * \brief Get the frequency of the running clock
+ *
+ * \retval the measured frequency if the running profile was verified, the
+ * nominal one otherwise
+ */
+uint32_t clock_scale_get_hz(void)
+{
+	uint32_t hz = clock_scale_measured_hz[clock_scale_profile];
+
+	return hz ? hz : clock_scale_main_hz;
+}
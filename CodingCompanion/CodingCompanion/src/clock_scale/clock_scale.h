@@ -0,0 +1,73 @@
+/**
+ * \file
+ *
+ * \brief Runtime clock scaling
+ *
+ * Switches the system clock between the 2 MHz oscillator it boots from, the
+ * PLL and the DFLL calibrated 32 MHz oscillator while the firmware runs. Work
+ * that needs speed locks a profile for as long as it runs, and the fastest
+ * locked profile is used; with no lock the clock drops back to 2 MHz.
+ *
+ * sysclk_get_main_hz() follows the running profile through the hook in
+ * conf_clock.h, so everything that derives a rate from the sysclk service
+ * at run time, the delay routines included, sees the current clock. Drivers
+ * that keep derived settings in registers register a notifier and re-derive
+ * them on a switch.
+ *
+ * The 32 MHz oscillator is calibrated by its DFLL against the reference of
+ * CONFIG_OSC_AUTOCAL_RC32MHZ_REF_OSC. clock_scale_verify() times it against
+ * the RTC crystal to confirm the lock, and clock_scale_get_hz() then gives
+ * the measured rather than the nominal frequency to derive rates from.
+ */
+#ifndef CLOCK_SCALE_H_INCLUDED
+#define CLOCK_SCALE_H_INCLUDED
+
+#include <compiler.h>
+#include <status_codes.h>
+#include <conf_clock_scale.h>
+
+//! Clock profiles, from the slowest
+enum clock_scale_profile {
+	//! 2 MHz internal oscillator, the clock at boot
+	CLOCK_SCALE_RC2M,
+	//! PLL from the 2 MHz oscillator, times CONFIG_CLOCK_SCALE_PLL_MUL
+	CLOCK_SCALE_PLL,
+	//! 32 MHz internal oscillator, calibrated by its DFLL
+	CLOCK_SCALE_RC32M,
+	CLOCK_SCALE_NR_OF_PROFILES,
+};
+
+//! Clock switch events
+enum clock_scale_event {
+	//! About to switch, with interrupts enabled and the old clock running
+	CLOCK_SCALE_PRE_CHANGE,
+	//! Switched, with interrupts disabled until every notifier has run
+	CLOCK_SCALE_POST_CHANGE,
+};
+
+//! Notifier callback, sysclk_get_per_hz() gives the new clock after a switch
+typedef void (*clock_scale_notify_t)(enum clock_scale_event event);
+
+/**
+ * \brief Clock switch notifier
+ *
+ * Owned by the driver. Only \a fn is set by the driver.
+ */
+struct clock_scale_notifier {
+	clock_scale_notify_t fn;
+	//! Next registered notifier
+	struct clock_scale_notifier *next;
+};
+
+//! Main clock frequency, read by sysclk_get_main_hz()
+extern uint32_t clock_scale_main_hz;
+
+void clock_scale_init(void);
+void clock_scale_register(struct clock_scale_notifier *notifier);
+void clock_scale_lock(enum clock_scale_profile profile);
+void clock_scale_unlock(enum clock_scale_profile profile);
+enum clock_scale_profile clock_scale_get_profile(void);
+status_code_t clock_scale_verify(void);
+uint32_t clock_scale_get_hz(void);
+
+#endif /* CLOCK_SCALE_H_INCLUDED */
@@ -0,0 +1,13 @@
+/**
+ * \file
+ *
+ * \brief Boot timing configuration
+ *
+ */
+#ifndef CONF_BOOT_H
+#define CONF_BOOT_H
+
+// Print the boot milestones on the console when 'b' is received
+//#define CONFIG_BOOT_CONSOLE
+
+#endif /* CONF_BOOT_H */
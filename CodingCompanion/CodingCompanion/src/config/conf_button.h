@@ -0,0 +1,28 @@
+/**
+ * \file
+ *
+ * \brief Button service configuration
+ *
+ */
+#ifndef CONF_BUTTON_H
+#define CONF_BUTTON_H
+
+// Pins of the buttons, button n is the nth pin; a pressed button pulls its
+// pin low
+#define CONFIG_BUTTON_PINS \
+	{GPIO_PUSH_BUTTON_0, GPIO_PUSH_BUTTON_1, GPIO_PUSH_BUTTON_2}
+// Ports the pins above are on, their INT0 interrupt is taken for pin changes
+#define CONFIG_BUTTON_PORTE
+#define CONFIG_BUTTON_PORTF
+
+// Time from the first edge until the level is taken as settled
+#define CONFIG_BUTTON_DEBOUNCE_MS    20
+// Time a button is held before a long press is reported
+#define CONFIG_BUTTON_LONG_PRESS_MS  1000
+// Time between repeats after a long press, 0 for no repeats
+#define CONFIG_BUTTON_REPEAT_MS      250
+
+// Events queued for the main context, power of two
+#define CONFIG_BUTTON_QUEUE_SIZE     16
+
+#endif /* CONF_BUTTON_H */
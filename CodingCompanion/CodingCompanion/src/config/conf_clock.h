@@ -66,6 +66,9 @@
 
 /* DFLL autocalibration */
 //#define CONFIG_OSC_AUTOCAL_RC2MHZ_REF_OSC  OSC_ID_RC32KHZ
+/* Reference of the RC32M DFLL for the 32 MHz clock profile, the RC32K is
+ * independent of the RTC crystal the lock is verified against */
+#define CONFIG_OSC_AUTOCAL_RC32MHZ_REF_OSC OSC_ID_RC32KHZ
 //#define CONFIG_OSC_AUTOCAL_RC32MHZ_REF_OSC OSC_ID_XOSC
 
 /* The following example clock configuration definitions can be used in XMEGA
@@ -88,4 +91,15 @@
 /* Use to enable and select RTC clock source */
 //#define CONFIG_RTC_SOURCE           SYSCLK_RTCSRC_ULP
 
+/* Main clock switched at run time, see clock_scale.h */
+#include <stdint.h>
+extern uint32_t clock_scale_main_hz;
+#define CONFIG_SYSCLK_MAIN_HZ_HOOK()  clock_scale_main_hz
+
+/* Peripheral clocks counted per user, see power_gate.h */
+extern void power_gate_acquire(uint8_t port, uint8_t mask);
+extern void power_gate_release(uint8_t port, uint8_t mask);
+#define CONFIG_SYSCLK_ENABLE_MODULE_HOOK(port, id)   power_gate_acquire(port, id)
+#define CONFIG_SYSCLK_DISABLE_MODULE_HOOK(port, id)  power_gate_release(port, id)
+
 #endif /* CONF_CLOCK_H_INCLUDED */
@@ -0,0 +1,22 @@
+/**
+ * \file
+ *
+ * \brief Runtime clock scaling configuration
+ *
+ */
+#ifndef CONF_CLOCK_SCALE_H
+#define CONF_CLOCK_SCALE_H
+
+// Multiplier of the PLL profile, which runs from the 2 MHz oscillator. The
+// resulting clock must be a power of two in MHz for the monotonic clock.
+#define CONFIG_CLOCK_SCALE_PLL_MUL     8
+
+// RTC ticks the 32 MHz profile is timed over to verify the DFLL lock, and
+// how many times it is timed before giving up
+#define CONFIG_CLOCK_SCALE_VERIFY_TICKS  128
+#define CONFIG_CLOCK_SCALE_VERIFY_TRIES  4
+// Largest error of a locked clock in ppm, well within what a USART
+// receiver tolerates
+#define CONFIG_CLOCK_SCALE_TOLERANCE_PPM 10000
+
+#endif /* CONF_CLOCK_SCALE_H */
@@ -0,0 +1,14 @@
+/**
+ * \file
+ *
+ * \brief Serial console configuration
+ *
+ */
+#ifndef CONF_CONSOLE_H
+#define CONF_CONSOLE_H
+
+// USART routed to the board controller's virtual COM port
+#define CONFIG_CONSOLE_USART     &USARTC0
+#define CONFIG_CONSOLE_BAUDRATE  38400
+
+#endif /* CONF_CONSOLE_H */
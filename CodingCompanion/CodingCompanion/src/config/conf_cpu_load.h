@@ -0,0 +1,16 @@
+/**
+ * \file
+ *
+ * \brief CPU load meter configuration
+ *
+ */
+#ifndef CONF_CPU_LOAD_H
+#define CONF_CPU_LOAD_H
+
+// Show the 1 s load in the top right corner of the display
+//#define CONFIG_CPU_LOAD_INDICATOR
+
+// Print the load on the console when 'l' is received
+//#define CONFIG_CPU_LOAD_CONSOLE
+
+#endif /* CONF_CPU_LOAD_H */
@@ -0,0 +1,21 @@
+/**
+ * \file
+ *
+ * \brief Deadline monitor configuration
+ *
+ */
+#ifndef CONF_DEADLINE_H
+#define CONF_DEADLINE_H
+
+// Reset the device through the watchdog when a watched activity stops
+// completing its runs
+//#define CONFIG_DEADLINE_WATCHDOG
+
+// Watchdog timeout, a WDTO_* value of avr/wdt.h, longer than the period
+// of every watched activity
+#define CONFIG_DEADLINE_WATCHDOG_TIMEOUT  WDTO_1S
+
+// Print the statistics on the console when 'd' is received
+//#define CONFIG_DEADLINE_CONSOLE
+
+#endif /* CONF_DEADLINE_H */
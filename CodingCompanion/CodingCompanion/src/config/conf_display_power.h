@@ -0,0 +1,29 @@
+/**
+ * \file
+ *
+ * \brief Display power configuration
+ *
+ */
+#ifndef CONF_DISPLAY_POWER_H
+#define CONF_DISPLAY_POWER_H
+
+// Timer counter and channel driving the backlight pin, PE4 is OC1A of TCE1
+#define CONFIG_DISPLAY_POWER_TC           TCE1
+#define CONFIG_DISPLAY_POWER_CHANNEL      TC_CCA
+
+// Backlight PWM frequency at the 2 MHz clock, 16 times higher while the
+// companion renders at 32 MHz, which leaves the duty cycle as it is
+#define CONFIG_DISPLAY_POWER_PWM_HZ       500
+
+// Ambient light in lux up to which the backlight is at its minimum, and from
+// which it is fully on
+#define CONFIG_DISPLAY_POWER_LUX_MIN      20
+#define CONFIG_DISPLAY_POWER_LUX_MAX      400
+
+// Lowest backlight brightness while the display is on, in percent
+#define CONFIG_DISPLAY_POWER_MIN_PERCENT  10
+
+// Seconds without button events or alerts before the display sleeps
+#define CONFIG_DISPLAY_POWER_TIMEOUT_S    60
+
+#endif /* CONF_DISPLAY_POWER_H */
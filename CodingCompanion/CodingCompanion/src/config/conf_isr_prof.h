@@ -0,0 +1,20 @@
+/**
+ * \file
+ *
+ * \brief ISR latency profiler configuration
+ *
+ */
+#ifndef CONF_ISR_PROF_H
+#define CONF_ISR_PROF_H
+
+// Record how late the timer and ADC interrupts run, and print the
+// histograms on the console when 'p' is received ('r' clears them)
+//#define CONFIG_ISR_PROF
+
+// Time from starting an ADC sweep until channel 0 completes, 7 ADC clock
+// cycles at 125 kHz for a 12-bit result, and the delay of each further
+// channel in the pipeline
+#define CONFIG_ISR_PROF_ADC_CONV_US  56
+#define CONFIG_ISR_PROF_ADC_CH_US    8
+
+#endif /* CONF_ISR_PROF_H */
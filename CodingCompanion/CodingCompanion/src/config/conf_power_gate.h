@@ -0,0 +1,14 @@
+/**
+ * \file
+ *
+ * \brief Peripheral power reduction configuration
+ *
+ */
+#ifndef CONF_POWER_GATE_H
+#define CONF_POWER_GATE_H
+
+// Print the power reduction registers and user counts on the console when
+// 'g' is received
+//#define CONFIG_POWER_GATE_CONSOLE
+
+#endif /* CONF_POWER_GATE_H */
@@ -0,0 +1,14 @@
+/**
+ * \file
+ *
+ * \brief RTC32 clock configuration
+ *
+ */
+#ifndef CONF_RTC_CLOCK_H
+#define CONF_RTC_CLOCK_H
+
+// Count the 32.768 kHz crystal of the backup domain divided down to
+// 1.024 kHz; comment out to count at 32.768 kHz
+#define CONFIG_RTC_CLOCK_1024HZ
+
+#endif /* CONF_RTC_CLOCK_H */
@@ -0,0 +1,14 @@
+/**
+ * \file
+ *
+ * \brief Sensor statistics configuration
+ *
+ */
+#ifndef CONF_SENSOR_STATS_H
+#define CONF_SENSOR_STATS_H
+
+// Print the summaries of the last complete windows on the console when 'a'
+// is received
+#define CONFIG_SENSOR_STATS_CONSOLE
+
+#endif /* CONF_SENSOR_STATS_H */
@@ -0,0 +1,21 @@
+/**
+ * \file
+ *
+ * \brief Sleeping delay configuration
+ *
+ */
+#ifndef CONF_SLEEP_DELAY_H
+#define CONF_SLEEP_DELAY_H
+
+// Timer counter the delays are timed on, TCC0 drives the buzzer
+#define CONFIG_SLEEP_DELAY_TC      TCC1
+
+// Shortest delay that is slept, shorter ones are counted in CPU cycles
+#define CONFIG_SLEEP_DELAY_MIN_US  10
+
+// Sleep through sleep_stats.h, so the time is accounted like that of the
+// scheduler
+#include <sleep_stats/sleep_stats.h>
+#define CONFIG_SLEEP_DELAY_ENTER_SLEEP()  sleep_stats_enter_sleep()
+
+#endif /* CONF_SLEEP_DELAY_H */
@@ -0,0 +1,16 @@
+/**
+ * \file
+ *
+ * \brief Sleep residency accounting configuration
+ *
+ */
+#ifndef CONF_SLEEP_STATS_H
+#define CONF_SLEEP_STATS_H
+
+// Account the time spent in each sleep mode and what woke the CPU
+#define CONFIG_SLEEP_STATS
+
+// Print the statistics on the console when 's' is received
+//#define CONFIG_SLEEP_STATS_CONSOLE
+
+#endif /* CONF_SLEEP_STATS_H */
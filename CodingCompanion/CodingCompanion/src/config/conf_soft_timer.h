@@ -0,0 +1,13 @@
+/**
+ * \file
+ *
+ * \brief Software timer configuration
+ *
+ */
+#ifndef CONF_SOFT_TIMER_H
+#define CONF_SOFT_TIMER_H
+
+// One timer tick is 2^shift microseconds, 1.024 ms by default
+#define CONFIG_SOFT_TIMER_TICK_SHIFT 10
+
+#endif /* CONF_SOFT_TIMER_H */
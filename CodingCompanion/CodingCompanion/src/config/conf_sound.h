@@ -0,0 +1,15 @@
+/**
+ * \file
+ *
+ * \brief Sound service configuration
+ *
+ */
+#ifndef CONF_SOUND_H
+#define CONF_SOUND_H
+
+// Timer counter generating the tone, and the pin of its compare channel A,
+// which the buzzer is on
+#define CONFIG_SOUND_TC   TCC0
+#define CONFIG_SOUND_PIN  J1_PIN0
+
+#endif /* CONF_SOUND_H */
@@ -88,4 +88,8 @@
 #define ST7565R_DISPLAY_CONTRAST_MAX 40
 #define ST7565R_DISPLAY_CONTRAST_MIN 30
 
+// The reset pulse is driven by main() around the rest of the bring-up
+// rather than with delays in st7565r_init()
+#define ST7565R_RESET_EXTERNAL
+
 #endif /* CONF_ST7565R_H_INCLUDED */
@@ -0,0 +1,21 @@
+/**
+ * \file
+ *
+ * \brief Monotonic clock configuration
+ *
+ */
+#ifndef CONF_SYSTIME_H
+#define CONF_SYSTIME_H
+
+// Timer counter counting microseconds, the low half of the clock
+#define CONFIG_SYSTIME_TC_LOW      TCD0
+// Timer counter counting overflows of the low one, the high half
+#define CONFIG_SYSTIME_TC_HIGH     TCD1
+// Event channel carrying the overflows from the low to the high counter, and
+// the overflow event of the low counter
+#define CONFIG_SYSTIME_EVSYS_CH    0
+#define CONFIG_SYSTIME_EVSYS_OVF   EVSYS_CHMUX_TCD0_OVF_gc
+// Event channel carrying clkPER divided down to 1 MHz to the low counter
+#define CONFIG_SYSTIME_EVSYS_CLK_CH  1
+
+#endif /* CONF_SYSTIME_H */
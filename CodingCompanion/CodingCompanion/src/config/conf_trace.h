@@ -0,0 +1,26 @@
+/**
+ * \file
+ *
+ * \brief Sensor trace configuration
+ *
+ */
+#ifndef CONF_TRACE_H
+#define CONF_TRACE_H
+
+// Log raw ADC results and button edges to the console
+//#define CONFIG_TRACE_CAPTURE
+
+// Replace ADC results and button reads with the trace in trace_data.h and
+// report cycles per loop and LCD bytes sent
+//#define CONFIG_TRACE_REPLAY
+
+// Records buffered between the interrupts and the console, power of two
+#define CONFIG_TRACE_BUFFER_SIZE 32
+
+// Timer counter and event channel counting the serial clock of the LCD while
+// replaying, its USART (USARTD0) clocks out on PD1
+#define CONFIG_TRACE_LCD_TC       TCF0
+#define CONFIG_TRACE_LCD_EVSYS_CH 2
+#define CONFIG_TRACE_LCD_CHMUX    EVSYS_CHMUX_PORTD_PIN1_gc
+
+#endif /* CONF_TRACE_H */
@@ -0,0 +1,14 @@
+/**
+ * \file
+ *
+ * \brief Deferred work configuration
+ *
+ */
+#ifndef CONF_WORK_H
+#define CONF_WORK_H
+
+// Serve pending low level interrupts in turn rather than by vector number,
+// so a busy vector can't starve the ones after it
+#define CONFIG_WORK_PMIC_ROUND_ROBIN
+
+#endif /* CONF_WORK_H */
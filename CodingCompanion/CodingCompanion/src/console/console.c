@@ -0,0 +1,156 @@
+/**
+ * \file
+ *
+ * \brief Serial console
+ *
+ */
+#include <asf.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <clock_scale/clock_scale.h>
+#include "console.h"
+
+//! \internal Line buffer for console_printf()
+static char console_buf[64];
+
+//! \internal Registered commands and their characters
+static char console_command_chars[CONSOLE_MAX_COMMANDS];
+static console_command_t console_commands[CONSOLE_MAX_COMMANDS];
+static uint8_t console_nr_of_commands;
+
+//! \internal Whether the USART is set up
+static bool console_ready;
+//! \internal Whether anything was sent, so a transmit complete will follow
+static bool console_sent;
+
+static struct clock_scale_notifier console_clock_notifier;
+
+/**
+ * \internal
+ * \brief Callback for clock switches
+ *
+ * Lets the last character out at the old baud rate, then derives the baud
+ * rate setting again for the new clock.
+ */
+static void console_clock_handler(enum clock_scale_event event)
+{
+	if (event == CLOCK_SCALE_PRE_CHANGE) {
+		while (console_sent && !usart_tx_is_complete(CONFIG_CONSOLE_USART)) {
+		}
+		return;
+	}
+	usart_set_baudrate(CONFIG_CONSOLE_USART, CONFIG_CONSOLE_BAUDRATE,
+			clock_scale_get_hz());
+}
+
+/**
+ * \brief Initialize the console USART
+ *
+ * 8 data bits, no parity, 1 stop bit at CONFIG_CONSOLE_BAUDRATE. Only the
+ * first call has an effect, so every module printing on the console may
+ * call it.
+ */
+void console_init(void)
+{
+	static const usart_rs232_options_t options = {
+		.baudrate = CONFIG_CONSOLE_BAUDRATE,
+		.charlength = USART_CHSIZE_8BIT_gc,
+		.paritytype = USART_PMODE_DISABLED_gc,
+		.stopbits = false,
+	};
+
+	if (console_ready) {
+		return;
+	}
+	usart_init_rs232(CONFIG_CONSOLE_USART, &options);
+	console_clock_notifier.fn = console_clock_handler;
+	clock_scale_register(&console_clock_notifier);
+	console_ready = true;
+}
+
+/**
+ * \brief Send one character, waiting for the transmitter if needed
+ */
+void console_putc(char c)
+{
+	usart_putchar(CONFIG_CONSOLE_USART, c);
+	/* Any earlier character is out of the shift register by now */
+	usart_clear_tx_complete(CONFIG_CONSOLE_USART);
+	console_sent = true;
+}
+
+/**
+ * \brief Send a string
+ */
+void console_puts(const char *str)
+{
+	while (*str) {
+		console_putc(*str++);
+	}
+}
+
+/**
+ * \brief Send formatted text
+ *
+ * Output longer than the internal line buffer is truncated.
+ */
+void console_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vsnprintf(console_buf, sizeof(console_buf), fmt, args);
+	va_end(args);
+	console_puts(console_buf);
+}
+
+/**
+ * \brief Get a received character without waiting
+ *
+ * \retval the character, or -1 if nothing was received
+ */
+int console_getc(void)
+{
+	if (!usart_rx_is_complete(CONFIG_CONSOLE_USART)) {
+		return -1;
+	}
+	return usart_get(CONFIG_CONSOLE_USART);
+}
+
+/**
+ * \brief Register a single-character command
+ *
+ * \param c the character that runs the command
+ * \param fn the command
+ */
+void console_register_command(char c, console_command_t fn)
+{
+	Assert(console_nr_of_commands < CONSOLE_MAX_COMMANDS);
+
+	console_command_chars[console_nr_of_commands] = c;
+	console_commands[console_nr_of_commands] = fn;
+	console_nr_of_commands++;
+}
+
+/**
+ * \brief Run the command of a received character, if any
+ *
+ * Does not touch the USART while no command is registered, so it may be
+ * called whether or not the console was initialized. Meant to be called
+ * from the main loop.
+ */
+void console_poll(void)
+{
+	int c;
+
+	if (!console_nr_of_commands) {
+		return;
+	}
+	c = console_getc();
+	for (uint8_t i = 0; i < console_nr_of_commands; i++) {
+		if (console_command_chars[i] == c) {
+			console_commands[i]();
+			return;
+		}
+	}
+}
@@ -0,0 +1,30 @@
+/**
+ * \file
+ *
+ * \brief Serial console
+ *
+ * Blocking text output and non-blocking input on the USART given in
+ * conf_console.h, for diagnostics that are read on a host. Modules register
+ * single-character commands, which console_poll() runs as they arrive.
+ */
+#ifndef CONSOLE_H_INCLUDED
+#define CONSOLE_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_console.h>
+
+//! Most single-character commands that can be registered
+#define CONSOLE_MAX_COMMANDS 8
+
+//! Console command, runs in the context of console_poll()
+typedef void (*console_command_t)(void);
+
+void console_init(void);
+void console_putc(char c);
+void console_puts(const char *str);
+void console_printf(const char *fmt, ...);
+int console_getc(void);
+void console_register_command(char c, console_command_t fn);
+void console_poll(void);
+
+#endif /* CONSOLE_H_INCLUDED */
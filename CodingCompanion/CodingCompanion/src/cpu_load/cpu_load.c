@@ -0,0 +1,235 @@
+/**
+ * \file
+ *
+ * \brief CPU load meter
+ *
+ */
+#include <asf.h>
+#include <soft_timer/soft_timer.h>
+#include <console/console.h>
+#include "cpu_load.h"
+
+//! \internal Number of one second samples kept, the longest window
+#define CPU_LOAD_NR_OF_SAMPLES 60
+
+//! \internal Samples making up each window
+static const uint8_t cpu_load_window_length[CPU_LOAD_NR_OF_WINDOWS] = {
+	1, 10, 60,
+};
+
+//! \internal Last one second samples, a ring indexed by cpu_load_head
+static uint16_t cpu_load_samples[CPU_LOAD_NR_OF_SAMPLES];
+static uint8_t cpu_load_head;
+//! \internal Number of valid samples, up to CPU_LOAD_NR_OF_SAMPLES
+static uint8_t cpu_load_count;
+//! \internal Sum of the samples of each window
+static uint32_t cpu_load_sum[CPU_LOAD_NR_OF_WINDOWS];
+
+//! \internal Highest sample, and sum and number of samples since the reset
+static uint16_t cpu_load_peak;
+static uint32_t cpu_load_total;
+static uint32_t cpu_load_total_count;
+
+//! \internal Idle time accumulated in the current sample, in microseconds
+static uint32_t cpu_load_idle_us;
+//! \internal Clock time idle began, valid while idle
+static uint32_t cpu_load_idle_since;
+static bool cpu_load_idle;
+//! \internal Clock time the current sample began
+static uint32_t cpu_load_sample_start;
+
+static struct soft_timer cpu_load_timer;
+
+/**
+ * \internal
+ * \brief Take a sample and add it to the windows
+ *
+ * Time spent idle up to now is counted in this sample even if the CPU is
+ * still idle.
+ */
+static void cpu_load_sample(void)
+{
+	irqflags_t flags;
+	uint32_t now;
+	uint32_t elapsed;
+	uint32_t busy;
+	uint16_t load;
+
+	flags = cpu_irq_save();
+	now = systime_now();
+	if (cpu_load_idle) {
+		cpu_load_idle_us += now - cpu_load_idle_since;
+		cpu_load_idle_since = now;
+	}
+	elapsed = now - cpu_load_sample_start;
+	busy = elapsed > cpu_load_idle_us ? elapsed - cpu_load_idle_us : 0;
+	cpu_load_idle_us = 0;
+	cpu_load_sample_start = now;
+	cpu_irq_restore(flags);
+
+	if (!elapsed) {
+		return;
+	}
+	/* busy fits 22 bits for any sample period of up to 4 s */
+	load = (busy << CPU_LOAD_FRAC_BITS) / elapsed;
+
+	for (uint8_t w = 0; w < CPU_LOAD_NR_OF_WINDOWS; w++) {
+		uint8_t length = cpu_load_window_length[w];
+
+		if (cpu_load_count >= length) {
+			uint8_t oldest = (cpu_load_head + CPU_LOAD_NR_OF_SAMPLES
+					- length) % CPU_LOAD_NR_OF_SAMPLES;
+
+			cpu_load_sum[w] -= cpu_load_samples[oldest];
+		}
+		cpu_load_sum[w] += load;
+	}
+	cpu_load_samples[cpu_load_head] = load;
+	cpu_load_head = (cpu_load_head + 1) % CPU_LOAD_NR_OF_SAMPLES;
+	if (cpu_load_count < CPU_LOAD_NR_OF_SAMPLES) {
+		cpu_load_count++;
+	}
+
+	if (load > cpu_load_peak) {
+		cpu_load_peak = load;
+	}
+	cpu_load_total += load;
+	cpu_load_total_count++;
+}
+
+/**
+ * \brief Start measuring the load
+ *
+ * \note Samples are taken by a software timer, so soft_timer_init() must be
+ * called first.
+ */
+void cpu_load_init(void)
+{
+	cpu_load_reset();
+	cpu_load_idle = false;
+	cpu_load_timer.callback = cpu_load_sample;
+	soft_timer_start(&cpu_load_timer, SOFT_TIMER_MS(1000),
+			SOFT_TIMER_MS(1000));
+#ifdef CONFIG_CPU_LOAD_CONSOLE
+	console_init();
+	console_register_command('l', cpu_load_dump);
+#endif
+}
+
+/**
+ * \brief Stamp the entry of the idle path
+ *
+ * Must be called with interrupts disabled, right before going to sleep.
+ */
+void cpu_load_idle_enter(void)
+{
+	cpu_load_idle_since = systime_now();
+	cpu_load_idle = true;
+}
+
+/**
+ * \brief Stamp the exit of the idle path
+ */
+void cpu_load_idle_exit(void)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	cpu_load_idle_us += systime_now() - cpu_load_idle_since;
+	cpu_load_idle = false;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Get the load over a window
+ *
+ * Until the window has filled up, the load is over the samples taken so
+ * far.
+ *
+ * \param window the window
+ *
+ * \retval the load, 0 before the first sample
+ */
+uint16_t cpu_load_get(enum cpu_load_window window)
+{
+	irqflags_t flags;
+	uint8_t length;
+	uint32_t sum;
+	uint8_t count;
+
+	Assert(window < CPU_LOAD_NR_OF_WINDOWS);
+
+	length = cpu_load_window_length[window];
+	flags = cpu_irq_save();
+	sum = cpu_load_sum[window];
+	count = cpu_load_count;
+	cpu_irq_restore(flags);
+
+	if (count > length) {
+		count = length;
+	}
+	return count ? sum / count : 0;
+}
+
+/**
+ * \brief Get the highest one second load since the last reset
+ */
+uint16_t cpu_load_get_peak(void)
+{
+	return cpu_load_peak;
+}
+
+/**
+ * \brief Get the average load since the last reset
+ */
+uint16_t cpu_load_get_average(void)
+{
+	irqflags_t flags;
+	uint32_t total;
+	uint32_t count;
+
+	flags = cpu_irq_save();
+	total = cpu_load_total;
+	count = cpu_load_total_count;
+	cpu_irq_restore(flags);
+
+	return count ? total / count : 0;
+}
+
+/**
+ * \brief Clear the samples, the peak and the average
+ */
+void cpu_load_reset(void)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	cpu_load_head = 0;
+	cpu_load_count = 0;
+	memset(cpu_load_sum, 0, sizeof(cpu_load_sum));
+	cpu_load_peak = 0;
+	cpu_load_total = 0;
+	cpu_load_total_count = 0;
+	cpu_load_idle_us = 0;
+	cpu_load_sample_start = systime_now();
+	if (cpu_load_idle) {
+		cpu_load_idle_since = cpu_load_sample_start;
+	}
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Print the load on the console
+ *
+ * One line "L 1s x 10s x 60s x peak x avg x", in percent.
+ */
+void cpu_load_dump(void)
+{
+	console_printf("L 1s %lu 10s %lu 60s %lu",
+			CPU_LOAD_PERCENT(cpu_load_get(CPU_LOAD_1S)),
+			CPU_LOAD_PERCENT(cpu_load_get(CPU_LOAD_10S)),
+			CPU_LOAD_PERCENT(cpu_load_get(CPU_LOAD_60S)));
+	console_printf(" peak %lu avg %lu\r\n",
+			CPU_LOAD_PERCENT(cpu_load_get_peak()),
+			CPU_LOAD_PERCENT(cpu_load_get_average()));
+}
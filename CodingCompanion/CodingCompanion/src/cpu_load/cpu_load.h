@@ -0,0 +1,47 @@
+/**
+ * \file
+ *
+ * \brief CPU load meter
+ *
+ * The idle path stamps its entry and exit with cpu_load_idle_enter() and
+ * cpu_load_idle_exit(). Once a second the time not spent idle is turned
+ * into a load sample, and the last 60 samples give the load over 1, 10 and
+ * 60 s windows. Loads are fixed point with CPU_LOAD_FRAC_BITS fractional
+ * bits, 1 << CPU_LOAD_FRAC_BITS being a fully loaded CPU.
+ *
+ * Interrupt handlers that wake the CPU from idle count as idle up to the
+ * return to the idle path.
+ */
+#ifndef CPU_LOAD_H_INCLUDED
+#define CPU_LOAD_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_cpu_load.h>
+
+//! Fractional bits of a load
+#define CPU_LOAD_FRAC_BITS 10
+//! Load of a CPU that is never idle
+#define CPU_LOAD_FULL (1 << CPU_LOAD_FRAC_BITS)
+
+//! Convert a load to whole percent, rounded
+#define CPU_LOAD_PERCENT(load) \
+	(((uint32_t)(load) * 100 + (CPU_LOAD_FULL / 2)) >> CPU_LOAD_FRAC_BITS)
+
+//! Load averaging windows
+enum cpu_load_window {
+	CPU_LOAD_1S,
+	CPU_LOAD_10S,
+	CPU_LOAD_60S,
+	CPU_LOAD_NR_OF_WINDOWS,
+};
+
+void cpu_load_init(void);
+void cpu_load_idle_enter(void);
+void cpu_load_idle_exit(void);
+uint16_t cpu_load_get(enum cpu_load_window window);
+uint16_t cpu_load_get_peak(void);
+uint16_t cpu_load_get_average(void);
+void cpu_load_reset(void);
+void cpu_load_dump(void);
+
+#endif /* CPU_LOAD_H_INCLUDED */
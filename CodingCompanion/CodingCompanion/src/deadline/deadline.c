@@ -0,0 +1,174 @@
+/**
+ * \file
+ *
+ * \brief Deadline-miss monitor for periodic work
+ *
+ */
+#include <asf.h>
+#include <avr/wdt.h>
+#include <console/console.h>
+#include "deadline.h"
+
+//! \internal Registered monitors, most recent first
+static struct deadline_monitor *deadline_monitors;
+//! \internal Watched activities, and those that completed a run since the
+//! watchdog was last reset
+static uint8_t deadline_watched;
+static uint8_t deadline_done;
+//! \internal Whether the last reset was caused by the watchdog
+static bool deadline_watchdog_reset;
+
+/**
+ * \brief Initialize the monitor
+ *
+ * Records and clears the watchdog reset flag, and registers the 'd' console
+ * command if configured.
+ */
+void deadline_init(void)
+{
+	deadline_monitors = NULL;
+	deadline_watched = 0;
+	deadline_done = 0;
+
+	deadline_watchdog_reset = RST.STATUS & RST_WDRF_bm;
+	RST.STATUS = RST_WDRF_bm;
+
+#ifdef CONFIG_DEADLINE_CONSOLE
+	console_init();
+	console_register_command('d', deadline_dump);
+#endif
+}
+
+/**
+ * \brief Start monitoring an activity
+ *
+ * The watchdog is started with the first watched activity.
+ *
+ * \param monitor the monitor, with \a period and \a budget set
+ */
+void deadline_register(struct deadline_monitor *monitor)
+{
+	uint8_t index = 0;
+
+	Assert(monitor->period);
+
+	monitor->runs = 0;
+	monitor->overruns = 0;
+	monitor->misses = 0;
+	monitor->worst = 0;
+	monitor->last = 0;
+	monitor->watch_bit = 0;
+	monitor->next = deadline_monitors;
+	deadline_monitors = monitor;
+
+	if (!monitor->watchdog) {
+		return;
+	}
+	while (deadline_watched & (1 << index)) {
+		index++;
+	}
+	Assert(index < DEADLINE_MAX_WATCHED);
+	monitor->watch_bit = 1 << index;
+	deadline_watched |= monitor->watch_bit;
+
+#ifdef CONFIG_DEADLINE_WATCHDOG
+	wdt_enable(CONFIG_DEADLINE_WATCHDOG_TIMEOUT);
+#endif
+}
+
+/**
+ * \brief Mark the beginning of a run
+ *
+ * A run that begins more than one and a half periods after the previous one
+ * counts as a miss, the activity skipped a period or fell behind it.
+ *
+ * \param monitor the monitor of the activity
+ */
+void deadline_begin(struct deadline_monitor *monitor)
+{
+	uint32_t now = systime_now();
+
+	if (monitor->runs
+			&& (now - monitor->start
+			> monitor->period + monitor->period / 2)) {
+		monitor->misses++;
+	}
+	monitor->start = now;
+}
+
+/**
+ * \brief Mark the end of a run
+ *
+ * Resets the watchdog once every watched activity has completed a run.
+ *
+ * \param monitor the monitor of the activity
+ */
+void deadline_end(struct deadline_monitor *monitor)
+{
+	uint32_t duration = systime_now() - monitor->start;
+
+	monitor->last = duration;
+	if (duration > monitor->worst) {
+		monitor->worst = duration;
+	}
+	if (duration > monitor->budget) {
+		monitor->overruns++;
+	}
+	monitor->runs++;
+
+	deadline_done |= monitor->watch_bit;
+	if (deadline_done == deadline_watched) {
+#ifdef CONFIG_DEADLINE_WATCHDOG
+		wdt_reset();
+#endif
+		deadline_done = 0;
+	}
+}
+
+/**
+ * \brief Clear the statistics of every activity
+ */
+void deadline_reset(void)
+{
+	struct deadline_monitor *monitor;
+
+	for (monitor = deadline_monitors; monitor; monitor = monitor->next) {
+		monitor->runs = 0;
+		monitor->overruns = 0;
+		monitor->misses = 0;
+		monitor->worst = 0;
+		monitor->last = 0;
+	}
+}
+
+/**
+ * \brief Print the statistics of every activity on the console
+ *
+ * One line "M name runs n overruns n misses n worst us last us budget us"
+ * per activity, times in microseconds, then "M end". A line "M watchdog"
+ * comes first if the device was reset by the watchdog.
+ */
+void deadline_dump(void)
+{
+	struct deadline_monitor *monitor;
+
+	if (deadline_watchdog_reset) {
+		console_puts("M watchdog\r\n");
+	}
+	for (monitor = deadline_monitors; monitor; monitor = monitor->next) {
+		console_printf("M %s runs %lu overruns %u misses %u",
+				monitor->name, monitor->runs, monitor->overruns,
+				monitor->misses);
+		console_printf(" worst %lu last %lu budget %lu\r\n",
+				monitor->worst, monitor->last, monitor->budget);
+	}
+	console_puts("M end\r\n");
+}
+
+/**
+ * \brief Check whether the last reset was caused by the watchdog
+ */
+bool deadline_was_watchdog_reset(void)
+{
+	return deadline_watchdog_reset;
+}
@@ -0,0 +1,66 @@
+/**
+ * \file
+ *
+ * \brief Deadline-miss monitor for periodic work
+ *
+ * A periodic activity declares its period and its budget, the longest it may
+ * run, and brackets each run with deadline_begin() and deadline_end(). The
+ * monitor keeps the number of runs, the runs over budget, the runs that began
+ * more than half a period late and the longest run, all timed on the
+ * monotonic clock.
+ *
+ * With CONFIG_DEADLINE_WATCHDOG the watchdog is only reset once every watched
+ * activity has completed a run, so one that hangs or stops being run resets
+ * the device.
+ */
+#ifndef DEADLINE_H_INCLUDED
+#define DEADLINE_H_INCLUDED
+
+#include <compiler.h>
+#include <systime/systime.h>
+#include <conf_deadline.h>
+
+//! Most activities that can be watched by the watchdog
+#define DEADLINE_MAX_WATCHED 8
+
+/**
+ * \brief Monitor of one periodic activity
+ *
+ * Owned by the caller. Only \a name, \a period, \a budget and \a watchdog are
+ * set by the caller, the rest is kept by the monitor.
+ */
+struct deadline_monitor {
+	//! Name printed by deadline_dump()
+	const char *name;
+	//! Intended time between the beginnings of two runs, in microseconds
+	uint32_t period;
+	//! Longest acceptable run, in microseconds
+	uint32_t budget;
+	//! Have the watchdog wait for this activity
+	bool watchdog;
+	//! Next registered monitor
+	struct deadline_monitor *next;
+	//! Clock time the current or last run began
+	uint32_t start;
+	//! Completed runs
+	uint32_t runs;
+	//! Runs longer than the budget
+	uint16_t overruns;
+	//! Runs that began more than half a period late
+	uint16_t misses;
+	//! Longest and last run, in microseconds
+	uint32_t worst;
+	uint32_t last;
+	//! Bit of the activity in the watchdog masks, 0 if not watched
+	uint8_t watch_bit;
+};
+
+void deadline_init(void);
+void deadline_register(struct deadline_monitor *monitor);
+void deadline_begin(struct deadline_monitor *monitor);
+void deadline_end(struct deadline_monitor *monitor);
+void deadline_reset(void);
+void deadline_dump(void);
+bool deadline_was_watchdog_reset(void);
+
+#endif /* DEADLINE_H_INCLUDED */
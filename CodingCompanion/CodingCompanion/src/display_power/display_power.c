@@ -0,0 +1,137 @@
+/**
+ * \file
+ *
+ * \brief Backlight dimming and sleep of the display
+ *
+ */
+#include <asf.h>
+#include <adc_sensors/adc_sensors.h>
+#include <rtc_clock/rtc_clock.h>
+#include <pwm/pwm.h>
+#include "display_power.h"
+
+static struct pwm display_power_pwm;
+//! \internal Ambient light in lux to backlight duty cycle
+static struct pwm_map display_power_map;
+//! \internal Lowest duty cycle while the display is on
+static uint16_t display_power_min_duty;
+//! \internal Duty cycle for the last ambient light
+static uint16_t display_power_duty;
+//! \internal Uptime of the last activity, in seconds
+static uint32_t display_power_last_activity;
+static bool display_power_on;
+
+/**
+ * \internal
+ * \brief Turn the backlight on at the current duty cycle
+ *
+ * \note The timer must be enabled, which holds the CPU in idle sleep.
+ */
+static void display_power_backlight_on(void)
+{
+	pwm_enable_channel(&display_power_pwm, CONFIG_DISPLAY_POWER_CHANNEL);
+	pwm_set_duty(&display_power_pwm, CONFIG_DISPLAY_POWER_CHANNEL,
+			display_power_duty);
+	pwm_start(&display_power_pwm);
+}
+
+/**
+ * \internal
+ * \brief Turn the backlight off and stop its timer
+ *
+ * The pin is kept driven low rather than released by the channel.
+ */
+static void display_power_backlight_off(void)
+{
+	pwm_stop(&display_power_pwm);
+	pwm_disable_channel(&display_power_pwm, CONFIG_DISPLAY_POWER_CHANNEL);
+	ioport_set_pin_low(LCD_BACKLIGHT_ENABLE_PIN);
+	ioport_set_pin_dir(LCD_BACKLIGHT_ENABLE_PIN, IOPORT_DIR_OUTPUT);
+	tc_disable(&CONFIG_DISPLAY_POWER_TC);
+}
+
+/**
+ * \brief Initialize the backlight PWM and turn the display on
+ *
+ * pwm_init() leaves the timer enabled. The backlight starts at full
+ * brightness until the first light reading.
+ *
+ * \note gfx_mono_init() and rtc_clock_init() must be called first.
+ */
+void display_power_init(void)
+{
+	pwm_init(&display_power_pwm, &CONFIG_DISPLAY_POWER_TC,
+			CONFIG_DISPLAY_POWER_PWM_HZ, false);
+	pwm_map_init(&display_power_map, &display_power_pwm,
+			CONFIG_DISPLAY_POWER_LUX_MIN, CONFIG_DISPLAY_POWER_LUX_MAX);
+	display_power_min_duty = ((uint32_t)display_power_pwm.period
+			* CONFIG_DISPLAY_POWER_MIN_PERCENT) / 100;
+	display_power_duty = display_power_pwm.period;
+
+	display_power_last_activity = rtc_clock_get_uptime();
+	display_power_on = true;
+	display_power_backlight_on();
+}
+
+/**
+ * \brief Dim the backlight to the ambient light
+ *
+ * The new duty cycle starts with the next PWM period, so the backlight does
+ * not flicker. While the display sleeps it is kept for the wake-up.
+ *
+ * \param level ambient light with LIGHT_LEVEL_FRAC_BITS fraction bits, as
+ * from lightsensor_get_level()
+ */
+void display_power_set_light(uint32_t level)
+{
+	uint32_t lux = level >> LIGHT_LEVEL_FRAC_BITS;
+	uint16_t duty;
+
+	duty = pwm_map(&display_power_map, min(lux, UINT16_MAX));
+	display_power_duty = max(duty, display_power_min_duty);
+
+	if (display_power_on) {
+		pwm_set_duty(&display_power_pwm, CONFIG_DISPLAY_POWER_CHANNEL,
+				display_power_duty);
+	}
+}
+
+/**
+ * \brief Restart the inactivity timeout, waking the display if it sleeps
+ *
+ * To be called on button events and alerts.
+ */
+void display_power_activity(void)
+{
+	display_power_last_activity = rtc_clock_get_uptime();
+	if (!display_power_on) {
+		st7565r_sleep_disable();
+		tc_enable(&CONFIG_DISPLAY_POWER_TC);
+		display_power_backlight_on();
+		display_power_on = true;
+	}
+}
+
+/**
+ * \brief Put the display to sleep once the inactivity timeout has passed
+ *
+ * To be called periodically, the timeout is checked to the second.
+ */
+void display_power_update(void)
+{
+	uint32_t idle = rtc_clock_get_uptime() - display_power_last_activity;
+
+	if (display_power_on && idle >= CONFIG_DISPLAY_POWER_TIMEOUT_S) {
+		display_power_backlight_off();
+		st7565r_sleep_enable();
+		display_power_on = false;
+	}
+}
+
+/**
+ * \brief Check whether the display is on
+ */
+bool display_power_is_on(void)
+{
+	return display_power_on;
+}
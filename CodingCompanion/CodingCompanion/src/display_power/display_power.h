@@ -0,0 +1,31 @@
+/**
+ * \file
+ *
+ * \brief Backlight dimming and sleep of the display
+ *
+ * Dims the backlight with PWM on CONFIG_DISPLAY_POWER_TC as the ambient light
+ * falls, from full brightness at CONFIG_DISPLAY_POWER_LUX_MAX down to
+ * CONFIG_DISPLAY_POWER_MIN_PERCENT at CONFIG_DISPLAY_POWER_LUX_MIN.
+ *
+ * After CONFIG_DISPLAY_POWER_TIMEOUT_S seconds of the RTC without activity
+ * the panel is blanked, the ST7565R is put in its power save mode and the
+ * backlight timer is stopped and its clock gated, which also lets the CPU
+ * sleep deeper than idle. The display RAM is kept and can still be drawn to,
+ * so display_power_activity() brings the display back as it was.
+ *
+ * All functions write to the LCD, so they must be called from the same
+ * context as the drawing.
+ */
+#ifndef DISPLAY_POWER_H_INCLUDED
+#define DISPLAY_POWER_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_display_power.h>
+
+void display_power_init(void);
+void display_power_set_light(uint32_t level);
+void display_power_activity(void);
+void display_power_update(void);
+bool display_power_is_on(void);
+
+#endif /* DISPLAY_POWER_H_INCLUDED */
@@ -0,0 +1,196 @@
+/**
+ * \file
+ *
+ * \brief ISR latency and jitter profiler
+ *
+ */
+#include <asf.h>
+#include <console/console.h>
+#include <systime/systime.h>
+#include "isr_prof.h"
+
+#ifdef CONFIG_ISR_PROF
+
+//! \internal Latency histogram of one vector
+struct isr_prof_hist {
+	//! Entries with a latency of 0, 1, 2-3, 4-7 ... microseconds
+	uint16_t bucket[ISR_PROF_NR_OF_BUCKETS];
+	//! Number of entries, saturating
+	uint16_t count;
+	//! Longest latency seen
+	uint16_t max;
+};
+
+//! \internal Histogram of each vector
+static struct isr_prof_hist isr_prof_hist[ISR_PROF_NR_OF_VECTORS];
+//! \internal Time each vector is expected to enter, see isr_prof_expect()
+static uint32_t isr_prof_expected[ISR_PROF_NR_OF_VECTORS];
+
+//! \internal Name of each vector in the dump
+static const char *const isr_prof_names[ISR_PROF_NR_OF_VECTORS] = {
+	"sched",
+	"soft_timer",
+	"systime_high",
+	"adc_ch0",
+	"adc_ch1",
+	"adc_ch2",
+	"adc_ch3",
+};
+
+/**
+ * \brief Start profiling
+ *
+ * Sets up the console the histograms are printed on, and its commands.
+ */
+void isr_prof_init(void)
+{
+	console_init();
+	console_register_command('p', isr_prof_dump);
+	console_register_command('r', isr_prof_reset);
+	isr_prof_reset();
+}
+
+/**
+ * \brief Record the entry of an interrupt handler
+ *
+ * \param vector the vector of the handler
+ * \param latency_us time from when the interrupt was due to the entry
+ */
+void isr_prof_record(enum isr_prof_vector vector, uint16_t latency_us)
+{
+	struct isr_prof_hist *hist = &isr_prof_hist[vector];
+	uint16_t rest = latency_us;
+	uint8_t bucket = 0;
+
+	while (rest && bucket < ISR_PROF_NR_OF_BUCKETS - 1) {
+		rest >>= 1;
+		bucket++;
+	}
+	if (hist->bucket[bucket] != 0xffff) {
+		hist->bucket[bucket]++;
+	}
+	if (hist->count != 0xffff) {
+		hist->count++;
+	}
+	if (latency_us > hist->max) {
+		hist->max = latency_us;
+	}
+}
+
+/**
+ * \brief Record the entry of a timer compare handler
+ *
+ * The compare was due when the counter matched the compare value, and the
+ * counter is taken to count microseconds.
+ *
+ * \param vector the vector of the handler
+ * \param tc the timer counter
+ * \param cc the compare channel that fired
+ */
+void isr_prof_tc_compare(enum isr_prof_vector vector, volatile void *tc,
+		enum tc_cc_channel_t cc)
+{
+	isr_prof_record(vector, tc_read_count(tc) - tc_read_cc(tc, cc));
+}
+
+/**
+ * \brief Record the entry of a handler due at a timer overflow
+ *
+ * The overflow was due when the counter wrapped to 0, and the counter is
+ * taken to count microseconds.
+ *
+ * \param vector the vector of the handler
+ * \param tc the timer counter that overflowed
+ */
+void isr_prof_tc_overflow(enum isr_prof_vector vector, volatile void *tc)
+{
+	isr_prof_record(vector, tc_read_count(tc));
+}
+
+/**
+ * \brief Set when a vector is due, for isr_prof_enter()
+ *
+ * \param vector the vector
+ * \param delay_us time from now until its interrupt is due
+ */
+void isr_prof_expect(enum isr_prof_vector vector, uint16_t delay_us)
+{
+	isr_prof_expected[vector] = systime_now() + delay_us;
+}
+
+/**
+ * \brief Record the entry of a handler against the time set with
+ * isr_prof_expect()
+ *
+ * A handler that runs early counts as running on time.
+ *
+ * \param vector the vector of the handler
+ */
+void isr_prof_enter(enum isr_prof_vector vector)
+{
+	int32_t late = systime_now() - isr_prof_expected[vector];
+
+	if (late < 0) {
+		late = 0;
+	} else if (late > 0xffff) {
+		late = 0xffff;
+	}
+	isr_prof_record(vector, late);
+}
+
+/**
+ * \brief Clear all histograms
+ */
+void isr_prof_reset(void)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	memset(isr_prof_hist, 0, sizeof(isr_prof_hist));
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Print all histograms on the console
+ *
+ * Each vector with entries is printed as a header line followed by its
+ * non-empty buckets:
+ *
+ * \code
+ * P <vector> count <n> max <us>
+ * P <vector> <from>-<to> <n>
+ * \endcode
+ */
+void isr_prof_dump(void)
+{
+	struct isr_prof_hist hist;
+	irqflags_t flags;
+
+	for (uint8_t v = 0; v < ISR_PROF_NR_OF_VECTORS; v++) {
+		flags = cpu_irq_save();
+		hist = isr_prof_hist[v];
+		cpu_irq_restore(flags);
+
+		if (!hist.count) {
+			continue;
+		}
+		console_printf("P %s count %u max %u\r\n", isr_prof_names[v],
+				hist.count, hist.max);
+		for (uint8_t b = 0; b < ISR_PROF_NR_OF_BUCKETS; b++) {
+			uint16_t from = b ? 1U << (b - 1) : 0;
+			uint16_t to = b ? (1U << b) - 1 : 0;
+
+			if (!hist.bucket[b]) {
+				continue;
+			}
+			if (b == ISR_PROF_NR_OF_BUCKETS - 1) {
+				to = 0xffff;
+			}
+			console_printf("P %s %u-%u %u\r\n", isr_prof_names[v],
+					from, to, hist.bucket[b]);
+		}
+	}
+	console_puts("P end\r\n");
+}
+
+#endif /* CONFIG_ISR_PROF */
@@ -0,0 +1,94 @@
+/**
+ * \file
+ *
+ * \brief ISR latency and jitter profiler
+ *
+ * With CONFIG_ISR_PROF defined, instrumented interrupt handlers report the
+ * time from when their interrupt was due to when they started running, and
+ * the profiler keeps a histogram per vector with power of two buckets in
+ * microseconds. Timer compares are due at their compare value and ADC
+ * completions at the nominal conversion time after the sweep started.
+ * The histograms are printed on the console with the 'p' command and
+ * cleared with 'r', see console_poll().
+ *
+ * Without CONFIG_ISR_PROF every hook compiles to nothing.
+ */
+#ifndef ISR_PROF_H_INCLUDED
+#define ISR_PROF_H_INCLUDED
+
+#include <compiler.h>
+#include <tc.h>
+#include <conf_isr_prof.h>
+
+//! Profiled interrupt vectors
+enum isr_prof_vector {
+	//! Scheduler alarm on the low counter of the clock
+	ISR_PROF_SCHED_ALARM,
+	//! Software timer alarm on the low counter of the clock
+	ISR_PROF_SOFT_TIMER_ALARM,
+	//! Either alarm on the high counter of the clock
+	ISR_PROF_SYSTIME_HIGH,
+	//! Completion of ADCA channels 0 to 3
+	ISR_PROF_ADC_CH0,
+	ISR_PROF_ADC_CH1,
+	ISR_PROF_ADC_CH2,
+	ISR_PROF_ADC_CH3,
+	ISR_PROF_NR_OF_VECTORS,
+};
+
+//! Number of histogram buckets, the last one counts everything above
+#define ISR_PROF_NR_OF_BUCKETS 16
+
+#ifdef CONFIG_ISR_PROF
+
+void isr_prof_init(void);
+void isr_prof_record(enum isr_prof_vector vector, uint16_t latency_us);
+void isr_prof_tc_compare(enum isr_prof_vector vector, volatile void *tc,
+		enum tc_cc_channel_t cc);
+void isr_prof_tc_overflow(enum isr_prof_vector vector, volatile void *tc);
+void isr_prof_expect(enum isr_prof_vector vector, uint16_t delay_us);
+void isr_prof_enter(enum isr_prof_vector vector);
+void isr_prof_reset(void);
+void isr_prof_dump(void);
+
+#else
+
+static inline void isr_prof_init(void)
+{
+}
+
+static inline void isr_prof_record(enum isr_prof_vector vector,
+		uint16_t latency_us)
+{
+}
+
+static inline void isr_prof_tc_compare(enum isr_prof_vector vector,
+		volatile void *tc, enum tc_cc_channel_t cc)
+{
+}
+
+static inline void isr_prof_tc_overflow(enum isr_prof_vector vector,
+		volatile void *tc)
+{
+}
+
+static inline void isr_prof_expect(enum isr_prof_vector vector,
+		uint16_t delay_us)
+{
+}
+
+static inline void isr_prof_enter(enum isr_prof_vector vector)
+{
+}
+
+static inline void isr_prof_reset(void)
+{
+}
+
+static inline void isr_prof_dump(void)
+{
+}
+
+#endif
+
+#endif /* ISR_PROF_H_INCLUDED */
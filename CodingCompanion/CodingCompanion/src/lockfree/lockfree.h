@@ -0,0 +1,244 @@
+/**
+ * \file
+ *
+ * \brief ISR-safe data handoff primitives
+ *
+ * Primitives to pass data between one interrupt handler and the main loop
+ * without masking interrupts:
+ * - a single-producer/single-consumer ring of fixed-size elements,
+ * - sequence-counted 16 and 32-bit snapshots, which give the reader a value
+ *   that was never torn by a concurrent write,
+ * - flag bitmaps that are set and consumed atomically.
+ *
+ * The ring and the snapshots rely on single-byte loads and stores being
+ * atomic on AVR, so each has exactly one writer per field. The flag bitmaps
+ * use the XMEGA LAS/LAC read-modify-write instructions.
+ */
+#ifndef LOCKFREE_H_INCLUDED
+#define LOCKFREE_H_INCLUDED
+
+#include <compiler.h>
+#include <interrupt.h>
+#include <string.h>
+
+/**
+ * \name Single-producer/single-consumer ring
+ *
+ * Only the producer writes \a head and only the consumer writes \a tail, so
+ * neither side needs to lock the other out. The capacity must be a power of
+ * two no larger than 128.
+ *
+ * @{
+ */
+
+struct lf_ring {
+	uint8_t *buf;
+	uint8_t elem_size;
+	uint8_t mask;
+	volatile uint8_t head;
+	volatile uint8_t tail;
+};
+
+/**
+ * \brief Initialize a ring
+ *
+ * \param ring the ring
+ * \param buf storage for \a capacity elements
+ * \param elem_size size of one element, in bytes
+ * \param capacity number of elements, a power of two up to 128
+ */
+static inline void lf_ring_init(struct lf_ring *ring, void *buf,
+		uint8_t elem_size, uint8_t capacity)
+{
+	Assert(capacity && capacity <= 128 && !(capacity & (capacity - 1)));
+	ring->buf = buf;
+	ring->elem_size = elem_size;
+	ring->mask = capacity - 1;
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+//! \brief Number of elements waiting in the ring
+static inline uint8_t lf_ring_count(const struct lf_ring *ring)
+{
+	return (uint8_t)(ring->head - ring->tail);
+}
+
+/**
+ * \brief Add an element to the ring, producer side only
+ *
+ * The element is copied in before the head is published, so the consumer
+ * never sees a partially written element.
+ *
+ * \retval true on success
+ * \retval false if the ring is full and the element was dropped
+ */
+static inline bool lf_ring_push(struct lf_ring *ring, const void *elem)
+{
+	uint8_t head = ring->head;
+
+	if ((uint8_t)(head - ring->tail) > ring->mask) {
+		return false;
+	}
+	memcpy(ring->buf + (uint16_t)(head & ring->mask) * ring->elem_size,
+			elem, ring->elem_size);
+	barrier();
+	ring->head = head + 1;
+	return true;
+}
+
+/**
+ * \brief Take the oldest element from the ring, consumer side only
+ *
+ * \retval true if an element was copied to \a elem
+ * \retval false if the ring is empty
+ */
+static inline bool lf_ring_pop(struct lf_ring *ring, void *elem)
+{
+	uint8_t tail = ring->tail;
+
+	if (tail == ring->head) {
+		return false;
+	}
+	memcpy(elem, ring->buf + (uint16_t)(tail & ring->mask) * ring->elem_size,
+			ring->elem_size);
+	barrier();
+	ring->tail = tail + 1;
+	return true;
+}
+
+//! @}
+
+/**
+ * \name Sequence-counted snapshots
+ *
+ * The writer makes the sequence odd while it updates the value, and the
+ * reader retries until it sees the same even sequence before and after its
+ * read. A write can only interrupt the reader, never the other way around, so
+ * the reader retries at most once per write.
+ *
+ * @{
+ */
+
+struct lf_snapshot16 {
+	volatile uint8_t seq;
+	volatile uint16_t value;
+};
+
+struct lf_snapshot32 {
+	volatile uint8_t seq;
+	volatile uint32_t value;
+};
+
+//! \brief Publish a new 16-bit value, single writer only
+static inline void lf_snapshot16_write(struct lf_snapshot16 *snap,
+		uint16_t value)
+{
+	snap->seq++;
+	barrier();
+	snap->value = value;
+	barrier();
+	snap->seq++;
+}
+
+//! \brief Read a consistent 16-bit value
+static inline uint16_t lf_snapshot16_read(const struct lf_snapshot16 *snap)
+{
+	uint8_t seq;
+	uint16_t value;
+
+	do {
+		seq = snap->seq;
+		barrier();
+		value = snap->value;
+		barrier();
+	} while ((seq & 1) || (seq != snap->seq));
+	return value;
+}
+
+//! \brief Publish a new 32-bit value, single writer only
+static inline void lf_snapshot32_write(struct lf_snapshot32 *snap,
+		uint32_t value)
+{
+	snap->seq++;
+	barrier();
+	snap->value = value;
+	barrier();
+	snap->seq++;
+}
+
+//! \brief Read a consistent 32-bit value
+static inline uint32_t lf_snapshot32_read(const struct lf_snapshot32 *snap)
+{
+	uint8_t seq;
+	uint32_t value;
+
+	do {
+		seq = snap->seq;
+		barrier();
+		value = snap->value;
+		barrier();
+	} while ((seq & 1) || (seq != snap->seq));
+	return value;
+}
+
+//! @}
+
+/**
+ * \name Atomic flag bitmaps
+ *
+ * Any context may set, clear or consume bits of the same byte. On devices
+ * without the LAS/LAC instructions the operations fall back to a short
+ * interrupt-masked section.
+ *
+ * @{
+ */
+
+//! \brief Atomically set the bits of \a mask
+static inline void lf_flags_set(volatile uint8_t *flags, uint8_t mask)
+{
+#ifdef __AVR_ISA_RMW__
+	asm volatile("las %a1, %0" : "+r" (mask) : "z" (flags) : "memory");
+#else
+	irqflags_t irqflags = cpu_irq_save();
+	*flags |= mask;
+	cpu_irq_restore(irqflags);
+#endif
+}
+
+//! \brief Atomically clear the bits of \a mask
+static inline void lf_flags_clear(volatile uint8_t *flags, uint8_t mask)
+{
+#ifdef __AVR_ISA_RMW__
+	asm volatile("lac %a1, %0" : "+r" (mask) : "z" (flags) : "memory");
+#else
+	irqflags_t irqflags = cpu_irq_save();
+	*flags &= ~mask;
+	cpu_irq_restore(irqflags);
+#endif
+}
+
+/**
+ * \brief Atomically clear the bits of \a mask and return which were set
+ *
+ * \retval the bits of \a mask that were set before they were cleared
+ */
+static inline uint8_t lf_flags_fetch_and_clear(volatile uint8_t *flags,
+		uint8_t mask)
+{
+	uint8_t old = mask;
+
+#ifdef __AVR_ISA_RMW__
+	asm volatile("lac %a1, %0" : "+r" (old) : "z" (flags) : "memory");
+#else
+	irqflags_t irqflags = cpu_irq_save();
+	old = *flags;
+	*flags &= ~mask;
+	cpu_irq_restore(irqflags);
+#endif
+	return old & mask;
+}
+
+//! @}
+
+#endif /* LOCKFREE_H_INCLUDED */
@@ -32,25 +32,62 @@
 #include <stdio.h>
 #include <math.h>
 #include <adc_sensors/adc_sensors.h>
+#include <sensor_stats/sensor_stats.h>
+#include <adc_sched/adc_sched.h>
+#include <trace/trace.h>
+#include <sched/sched.h>
+#include <soft_timer/soft_timer.h>
+#include <button/button.h>
+#include <sound/sound.h>
+#include <isr_prof/isr_prof.h>
+#include <console/console.h>
+#include <deadline/deadline.h>
+#include <clock_scale/clock_scale.h>
+#include <rtc_clock/rtc_clock.h>
+#include <sleep_stats/sleep_stats.h>
+#include <cpu_load/cpu_load.h>
+#include <boot/boot.h>
+#include <power_gate/power_gate.h>
+#include <sleep_delay/sleep_delay.h>
+#include <display_power/display_power.h>
+#include <work/work.h>
 
 static char strbuf[128];
 
 #define LIGHT_Y 6 * 1
-#define LIGHT_THRESHOLD_MINOR 100
-#define LIGHT_THRESHOLD_MAJOR 50
+#define LIGHT_THRESHOLD_MINOR (100 << LIGHT_LEVEL_FRAC_BITS)
+#define LIGHT_THRESHOLD_MAJOR (50 << LIGHT_LEVEL_FRAC_BITS)
 #define SIT_Y 6 * 11
+#define SIT_BUTTON 1
+// seconds of sitting after which the sit alert is raised, and escalated
 #define SIT_THRESHOLD_MINOR 1
 #define SIT_THRESHOLD_MAJOR 2
 #define TEMP_Y 6 * 17
 #define TEMP_THRESHOLD_HOT 35
 #define TEMP_THRESHOLD_COLD 20
+#define LOAD_X 6 * 17
+// how often sensors are read and the display is refreshed
+#define COMPANION_PERIOD_MS 100
+// longest a companion run may take before it counts as an overrun
+#define COMPANION_BUDGET_MS 20
+// how often the bring-up checks on the rtc crystal
+#define BRING_UP_PERIOD_MS 10
 
 // sensor results
-// light
-uint32_t light_intensity_sum = 0;
-uint32_t light_intensity_count = 0;
-// button
-uint32_t button_pressed_duration = 0;
+// light and temperature summaries over 1 s, 1 min and 1 h
+static const uint32_t stats_window_length[SENSOR_STATS_NR_OF_WINDOWS] = {1, 60, 3600};
+struct sensor_stats light_stats;
+struct sensor_stats temp_stats;
+// latest readings
+uint32_t light_intensity = 0;
+int8_t room_temperature = 0;
+// whether the readings above were taken yet, no alert is raised before
+bool have_light = false;
+bool have_temperature = false;
+// uptime at which the sit button was last pressed, in seconds of the rtc
+uint32_t sitting_since = 0;
+// how often the summary of the last hour is printed, in seconds
+#define SUMMARY_PERIOD_S 3600
 
 enum severity
 {
@@ -74,258 +111,514 @@ enum message_type
 
 enum message_type current_message = MESSAGE_TYPE_NONE;
 
-void update_sitting_duration(void);
-void update_sitting_duration()
+// the sit alert is raised by an rtc alarm armed on the sit press, the
+// companion only picks up the severity the alarm left
+volatile enum severity sit_alarm_severity = SEVERITY_OK;
+
+void sit_alarm_handler(void);
+static struct rtc_clock_alarm sit_alarm = {.callback = sit_alarm_handler};
+
+// seconds until the sit alarm checks on the next threshold, at least 1;
+// the uptime only counts whole seconds, so a threshold has surely passed
+// once the sitting time counts a second more
+uint32_t sit_alarm_delay(uint32_t sitting);
+uint32_t sit_alarm_delay(uint32_t sitting)
+{
+	uint32_t threshold = (sit_alarm_severity == SEVERITY_OK) ? SIT_THRESHOLD_MINOR : SIT_THRESHOLD_MAJOR;
+
+	return (sitting <= threshold) ? threshold + 1 - sitting : 1;
+}
+
+// runs in the rtc interrupt, raises the alert a step for each threshold
+// the sitting time is past
+void sit_alarm_handler()
 {
-	// handle sitting duration
-	if (!ioport_get_pin_level(GPIO_PUSH_BUTTON_1))
+	uint32_t sitting = rtc_clock_get_uptime() - sitting_since;
+
+	if ((sit_alarm_severity == SEVERITY_OK) && (sitting > SIT_THRESHOLD_MINOR))
 	{
-		button_pressed_duration++;
+		sit_alarm_severity = SEVERITY_MINOR;
 	}
-	else
+	if ((sit_alarm_severity == SEVERITY_MINOR) && (sitting > SIT_THRESHOLD_MAJOR))
+	{
+		sit_alarm_severity = SEVERITY_MAJOR;
+	}
+	if (sit_alarm_severity != SEVERITY_MAJOR)
 	{
-		button_pressed_duration = 0;
+		rtc_clock_alarm_start(&sit_alarm, sit_alarm_delay(sitting), 0);
 	}
 }
 
-void setup_sitting_timer(void);
-void setup_sitting_timer()
-{
-	tc_enable(&TCC0);
-	tc_set_overflow_interrupt_callback(&TCC0, update_sitting_duration);
-	tc_set_wgm(&TCC0, TC_WG_NORMAL);
-	tc_write_period(&TCC0, 2000);
-	tc_set_overflow_interrupt_level(&TCC0, TC_INT_LVL_LO);
-	tc_write_clock_source(&TCC0, TC_CLKSEL_DIV1024_gc);
-}
+// the hourly summary is posted from an rtc alarm and printed in the main
+// context, where the console may take its time
+void print_summary(void);
+static struct work summary_work = {.fn = print_summary, .priority = WORK_PRIORITY_LOW};
 
-int main(void)
+void summary_alarm_handler(void);
+static struct rtc_clock_alarm summary_alarm = {.callback = summary_alarm_handler};
+
+void summary_alarm_handler()
 {
-	/* Insert system clock initialization code here (sysclk_init()). */
+	work_post(&summary_work);
+}
 
-	// inits
-	board_init();
-	sysclk_init();
-	pmic_init();
-	gfx_mono_init();
+#ifdef CONFIG_CPU_LOAD_INDICATOR
+// cpu load on display, in percent
+uint32_t shown_load = UINT32_MAX;
+#endif
 
-	// Wait for RTC32 sysclk to become stable
-	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_RTC);
-	while (RTC32.SYNCCTRL & RTC32_SYNCBUSY_bm)
+// keep the lcd serial clock at ST7565R_CLOCK_SPEED across clock switches
+void lcd_clock_handler(enum clock_scale_event event);
+void lcd_clock_handler(enum clock_scale_event event)
+{
+	if (event == CLOCK_SCALE_POST_CHANGE)
 	{
+		usart_spi_set_baudrate(ST7565R_USART_SPI, ST7565R_CLOCK_SPEED, clock_scale_get_hz());
 	}
-	delay_ms(1000);
-
-	// setup timer
-	setup_sitting_timer();
-	cpu_irq_enable();
+}
 
-	// setup adc
-	adc_sensors_init();
+static struct clock_scale_notifier lcd_clock_notifier = {.fn = lcd_clock_handler};
+// clock the companion renders at, 32 MHz once its lock is verified
+enum clock_scale_profile companion_clock = CLOCK_SCALE_RC2M;
 
-	// setup ioport
-	// turn on lcd
-	ioport_set_pin_level(LCD_BACKLIGHT_ENABLE_PIN, IOPORT_PIN_LEVEL_HIGH);
-	// set j1.0 as output
-	ioport_set_pin_dir(J1_PIN0, IOPORT_DIR_OUTPUT);
+// run times of the companion against its period and budget
+static struct deadline_monitor companion_monitor = {
+	.name = "companion",
+	.period = SCHED_MS(COMPANION_PERIOD_MS),
+	.budget = SCHED_MS(COMPANION_BUDGET_MS),
+	.watchdog = true,
+};
 
-	// print name and skeleton
-	gfx_mono_draw_string("Coding Companion", 0, 0, &sysfont);
-	gfx_mono_draw_string("L    0lx  S 0h  T  0c", 0, 8, &sysfont);
+void update_companion(void);
+void update_companion()
+{
+	deadline_begin(&companion_monitor);
+	// render at 32 MHz, the clock drops back to 2 MHz while the cpu sleeps
+	clock_scale_lock(companion_clock);
+	trace_loop_begin();
 
-	//forever loop
-	while (1)
+	// sensor readings
+	// results of the conversions started on the previous run
+	uint32_t now = rtc_clock_get_uptime();
+	// LIGHT
+	// display light intensity when a new reading is ready
+	// auto-ranged, so dim readings keep their resolution
+	if (lightsensor_data_is_ready())
 	{
-		// sensor readings
-		// LIGHT
-		// get light intensity and wait until it is ready
-		lightsensor_measure();
-		while (!lightsensor_data_is_ready())
+		light_intensity = lightsensor_get_level();
+		have_light = true;
+		boot_mark(BOOT_STAGE_SAMPLE);
+		// the statistics are kept in whole lux
+		sensor_stats_add(&light_stats, min(light_intensity >> LIGHT_LEVEL_FRAC_BITS, INT16_MAX), now);
+		// dim the backlight along with the ambient light
+		display_power_set_light(light_intensity);
+		snprintf(strbuf, sizeof(strbuf), "%5lu", light_intensity >> LIGHT_LEVEL_FRAC_BITS);
+		gfx_mono_draw_string(strbuf, LIGHT_Y, 8, &sysfont);
+	}
+	// BUTTON
+	// the sit button is held down while sitting, time it from its press
+	struct button_event event;
+	while (button_get_event(&event))
+	{
+		// any button wakes the display
+		display_power_activity();
+		if (event.button != SIT_BUTTON)
 		{
+			continue;
 		}
-		// TEMP
-		// measure temp and wait until it is ready
-		ntc_measure();
-		while (!ntc_data_is_ready())
+		// rearm the alert from scratch on either edge
+		rtc_clock_alarm_cancel(&sit_alarm);
+		sit_alarm_severity = SEVERITY_OK;
+		if (event.type == BUTTON_EVENT_PRESS)
 		{
+			// date the press from its timestamp, not from when the
+			// event was taken off the queue; the uptime stays at 0 until
+			// the rtc is ready, so the press is not dated before that
+			uint32_t age = (systime_now() - event.time) / SYSTIME_TICKS_PER_SEC;
+			sitting_since = now - min(age, now);
+			rtc_clock_alarm_start(&sit_alarm, sit_alarm_delay(now - sitting_since), 0);
 		}
-
-		// display light intensity
-		uint32_t light_intensity = lightsensor_get_raw_value();
-		snprintf(strbuf, sizeof(strbuf), "%5lu", light_intensity);
-		gfx_mono_draw_string(strbuf, LIGHT_Y, 8, &sysfont);
-		// display sitting duration
-		// uint32_t sitting_duration = floor(button_pressed_duration / 3600);
-		uint32_t sitting_duration = button_pressed_duration;
-		snprintf(strbuf, sizeof(strbuf), "%2lu", sitting_duration);
-		gfx_mono_draw_string(strbuf, SIT_Y, 8, &sysfont);
-		// display room temperature
-		int8_t room_temperature = ntc_get_temperature();
+	}
+	// display sitting duration
+	uint32_t sitting_duration = 0;
+	if (button_is_pressed(SIT_BUTTON))
+	{
+		// sitting_duration = floor((now - sitting_since) / 3600);
+		sitting_duration = now - sitting_since;
+	}
+	snprintf(strbuf, sizeof(strbuf), "%2lu", sitting_duration);
+	gfx_mono_draw_string(strbuf, SIT_Y, 8, &sysfont);
+	// TEMP
+	// display room temperature when a new reading is ready
+	if (ntc_data_is_ready())
+	{
+		room_temperature = ntc_get_temperature();
+		have_temperature = true;
+		sensor_stats_add(&temp_stats, room_temperature, now);
 		snprintf(strbuf, sizeof(strbuf), "%3d", room_temperature);
 		gfx_mono_draw_string(strbuf, TEMP_Y, 8, &sysfont);
+	}
+	// STATS
+	// close the windows that ended, also without a new reading
+	sensor_stats_update(&light_stats, now);
+	sensor_stats_update(&temp_stats, now);
 
-		// determine severity
-		// light severity
-		enum severity prev_light_severity = light_severity;
-		if (light_intensity < LIGHT_THRESHOLD_MINOR)
+	// determine severity
+	// light severity
+	enum severity prev_light_severity = light_severity;
+	if (!have_light)
+	{
+		light_severity = SEVERITY_OK;
+	}
+	else if (light_intensity < LIGHT_THRESHOLD_MINOR)
+	{
+		if (light_intensity > LIGHT_THRESHOLD_MAJOR)
 		{
-			if (light_intensity > LIGHT_THRESHOLD_MAJOR)
-			{
-				light_severity = SEVERITY_MINOR;
-			}
-			else
-			{
-				light_severity = SEVERITY_MAJOR;
-			}
+			light_severity = SEVERITY_MINOR;
 		}
 		else
 		{
-			light_severity = SEVERITY_OK;
+			light_severity = SEVERITY_MAJOR;
 		}
-		// sitting duration
-		enum severity prev_sit_severity = sit_severity;
-		if (sitting_duration >= SIT_THRESHOLD_MINOR)
+	}
+	else
+	{
+		light_severity = SEVERITY_OK;
+	}
+	// sitting duration, as far as the sit alarm got
+	enum severity prev_sit_severity = sit_severity;
+	sit_severity = sit_alarm_severity;
+	// room temperature
+	enum severity prev_temp_severity = temp_severity;
+	if (!have_temperature)
+	{
+		temp_severity = SEVERITY_OK;
+	}
+	else if (room_temperature > TEMP_THRESHOLD_HOT)
+	{
+		temp_severity = SEVERITY_MINOR;
+	}
+	else if (room_temperature < TEMP_THRESHOLD_COLD)
+	{
+		temp_severity = SEVERITY_MAJOR;
+	}
+	else
+	{
+		temp_severity = SEVERITY_OK;
+	}
+
+	// turn on led on warning
+	// light
+	if (light_severity != prev_light_severity)
+	{
+		if (light_severity > SEVERITY_OK)
 		{
-			if (sitting_duration < SIT_THRESHOLD_MAJOR)
-			{
-				sit_severity = SEVERITY_MINOR;
-			}
-			else
-			{
-				sit_severity = SEVERITY_MAJOR;
-			}
+			ioport_set_pin_level(LED0_GPIO, IOPORT_PIN_LEVEL_LOW);
 		}
 		else
 		{
-			sit_severity = SEVERITY_OK;
+			ioport_set_pin_level(LED0_GPIO, IOPORT_PIN_LEVEL_HIGH);
 		}
-		// room temperature
-		enum severity prev_temp_severity = temp_severity;
-		if (room_temperature > TEMP_THRESHOLD_HOT)
+	}
+	// sitting
+	if (sit_severity != prev_sit_severity)
+	{
+		if (sit_severity > SEVERITY_OK)
 		{
-			temp_severity = SEVERITY_MINOR;
+			ioport_set_pin_level(LED1_GPIO, IOPORT_PIN_LEVEL_LOW);
 		}
-		else if (room_temperature < TEMP_THRESHOLD_COLD)
+		else
 		{
-			temp_severity = SEVERITY_MAJOR;
+			ioport_set_pin_level(LED1_GPIO, IOPORT_PIN_LEVEL_HIGH);
+		}
+	}
+	// temperature
+	if (temp_severity != prev_temp_severity)
+	{
+		if (temp_severity > SEVERITY_OK)
+		{
+			ioport_set_pin_level(LED2_GPIO, IOPORT_PIN_LEVEL_LOW);
 		}
 		else
 		{
-			temp_severity = SEVERITY_OK;
+			ioport_set_pin_level(LED2_GPIO, IOPORT_PIN_LEVEL_HIGH);
 		}
+	}
 
-		// turn on led on warning
-		// light
-		if (light_severity != prev_light_severity)
+	// wake the display on a new or worse alert
+	if ((light_severity > prev_light_severity) || (sit_severity > prev_sit_severity) || ((temp_severity != prev_temp_severity) && (temp_severity > SEVERITY_OK)))
+	{
+		display_power_activity();
+	}
+
+	// buzzer handling
+	// a major alert repeats until it clears, a minor one beeps once
+	if ((light_severity != prev_light_severity) || (sit_severity != prev_sit_severity))
+	{
+		if ((light_severity == SEVERITY_MAJOR) || (sit_severity == SEVERITY_MAJOR))
 		{
-			if (light_severity > SEVERITY_OK)
-			{
-				ioport_set_pin_level(LED0_GPIO, IOPORT_PIN_LEVEL_LOW);
-			}
-			else
-			{
-				ioport_set_pin_level(LED0_GPIO, IOPORT_PIN_LEVEL_HIGH);
-			}
+			sound_play(sound_alert_major, true);
 		}
-		// sitting
-		if (sit_severity != prev_sit_severity)
+		else if ((light_severity == SEVERITY_MINOR) || (sit_severity == SEVERITY_MINOR))
 		{
-			if (sit_severity > SEVERITY_OK)
-			{
-				ioport_set_pin_level(LED1_GPIO, IOPORT_PIN_LEVEL_LOW);
-			}
-			else
-			{
-				ioport_set_pin_level(LED1_GPIO, IOPORT_PIN_LEVEL_HIGH);
-			}
+			sound_play(sound_alert_minor, false);
 		}
-		// temperature
-		if (temp_severity != prev_temp_severity)
+		else
 		{
-			if (temp_severity > SEVERITY_OK)
-			{
-				ioport_set_pin_level(LED2_GPIO, IOPORT_PIN_LEVEL_LOW);
-			}
-			else
-			{
-				ioport_set_pin_level(LED2_GPIO, IOPORT_PIN_LEVEL_HIGH);
-			}
+			sound_stop();
 		}
+	}
 
-		// buzzer handling
-		if ((light_severity != prev_light_severity) || (sit_severity != prev_sit_severity))
+	// message handling
+	// decide what to display
+	enum message_type prev_message = current_message;
+	if (light_severity > SEVERITY_OK)
+	{
+		current_message = MESSAGE_TYPE_LIGHT;
+	}
+	else if (sit_severity > SEVERITY_OK)
+	{
+		current_message = MESSAGE_TYPE_SIT;
+	}
+	else if (temp_severity == SEVERITY_MINOR)
+	{
+		current_message = MESSAGE_TYPE_HOT;
+	}
+	else if (temp_severity == SEVERITY_MAJOR)
+	{
+		current_message = MESSAGE_TYPE_COLD;
+	}
+	else
+	{
+		current_message = MESSAGE_TYPE_NONE;
+	}
+	// check whether to rewrite
+	if (current_message != prev_message)
+	{
+		if (current_message == MESSAGE_TYPE_LIGHT)
 		{
-			if ((light_severity == SEVERITY_MAJOR) || (sit_severity == SEVERITY_MAJOR))
-			{
-				ioport_set_pin_level(J1_PIN0, IOPORT_PIN_LEVEL_HIGH);
-			}
-			else
-			{
-				ioport_set_pin_level(J1_PIN0, IOPORT_PIN_LEVEL_LOW);
-			}
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Ambient is too dark");
+			gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Turn on some light");
+			gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
 		}
-
-		// message handling
-		// decide what to display
-		enum message_type prev_message = current_message;
-		if (light_severity > SEVERITY_OK)
+		else if (current_message == MESSAGE_TYPE_SIT)
 		{
-			current_message = MESSAGE_TYPE_LIGHT;
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Sat for too long");
+			gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Please stand up");
+			gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
 		}
-		else if (sit_severity > SEVERITY_OK)
+		else if (current_message == MESSAGE_TYPE_HOT)
 		{
-			current_message = MESSAGE_TYPE_SIT;
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Room is too hot");
+			gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Please turn on AC");
+			gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
 		}
-		else if (temp_severity == SEVERITY_MINOR)
+		else if (current_message == MESSAGE_TYPE_COLD)
 		{
-			current_message = MESSAGE_TYPE_HOT;
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Room is too cold");
+			gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "Please turn off AC");
+			gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
 		}
-		else if (temp_severity == SEVERITY_MAJOR)
+		else
 		{
-			current_message = MESSAGE_TYPE_COLD;
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "");
+			gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
+			snprintf(strbuf, sizeof(strbuf), "%-21s", "");
+			gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
 		}
-		else
+	}
+
+#ifdef CONFIG_CPU_LOAD_INDICATOR
+	// display cpu load over the last second when it changes
+	uint32_t load = CPU_LOAD_PERCENT(cpu_load_get(CPU_LOAD_1S));
+	if (load != shown_load)
+	{
+		shown_load = load;
+		snprintf(strbuf, sizeof(strbuf), "%3lu%%", load);
+		gfx_mono_draw_string(strbuf, LOAD_X, 0, &sysfont);
+	}
+#endif
+
+	// blank and sleep the display once nothing happened for a while
+	display_power_update();
+
+	// start the conversions that are due, their results are picked up on
+	// the next run; the NTC is only due every NTC_SENSOR_PERIOD runs
+	adc_sched_tick();
+
+	// run the diagnostic commands received on the console, if any
+	console_poll();
+
+	trace_loop_end();
+	clock_scale_unlock(companion_clock);
+	deadline_end(&companion_monitor);
+}
+
+static struct sched_task companion_task = {.fn = update_companion};
+
+#ifdef CONFIG_SENSOR_STATS_CONSOLE
+// print the light and temperature summaries of the last complete 1 s, 1 min
+// and 1 h windows
+void print_stats(void);
+void print_stats()
+{
+	for (uint8_t i = 0; i < SENSOR_STATS_NR_OF_WINDOWS; i++)
+	{
+		sensor_stats_print(&light_stats, "light", i);
+		sensor_stats_print(&temp_stats, "temp", i);
+	}
+}
+#endif
+
+// print the light and temperature summaries of the hour that just ended
+void print_summary()
+{
+	uint32_t now = rtc_clock_get_uptime();
+
+	// the companion may not have closed the window yet
+	sensor_stats_update(&light_stats, now);
+	sensor_stats_update(&temp_stats, now);
+#ifdef CONFIG_SENSOR_STATS_CONSOLE
+	sensor_stats_print(&light_stats, "light", SENSOR_STATS_NR_OF_WINDOWS - 1);
+	sensor_stats_print(&temp_stats, "temp", SENSOR_STATS_NR_OF_WINDOWS - 1);
+#endif
+}
+
+// steps of the bring-up left to the scheduler, so the companion starts
+// sampling without waiting for the rtc crystal
+enum bring_up_step
+{
+	BRING_UP_RTC,
+	BRING_UP_CLOCK
+};
+
+enum bring_up_step bring_up_step = BRING_UP_RTC;
+
+void bring_up(void);
+static struct sched_task bring_up_task = {.fn = bring_up};
+
+void bring_up()
+{
+	if (bring_up_step == BRING_UP_RTC)
+	{
+		// the crystal of a reset backup domain takes up to a second to start
+		if (rtc_clock_poll())
+		{
+			boot_mark(BOOT_STAGE_RTC);
+			// the hour windows of the summaries count from here
+			rtc_clock_alarm_start(&summary_alarm, SUMMARY_PERIOD_S, SUMMARY_PERIOD_S);
+			bring_up_step = BRING_UP_CLOCK;
+		}
+	}
+	else
+	{
+		// render at 32 MHz only if its DFLL lock checks out against the
+		// RTC, the check is polled on each run until it is done
+		status_code_t status = clock_scale_verify();
+		if (status == OPERATION_IN_PROGRESS)
 		{
-			current_message = MESSAGE_TYPE_NONE;
+			return;
 		}
-		// check whether to rewrite
-		if (current_message != prev_message)
+		if (status == STATUS_OK)
 		{
-			if (current_message == MESSAGE_TYPE_LIGHT)
-			{
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Ambient is too dark");
-				gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Turn on some light");
-				gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
-			}
-			else if (current_message == MESSAGE_TYPE_SIT)
-			{
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Sat for too long");
-				gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Please stand up");
-				gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
-			}
-			else if (current_message == MESSAGE_TYPE_HOT)
-			{
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Room is too hot");
-				gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Please turn on AC");
-				gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
-			}
-			else if (current_message == MESSAGE_TYPE_COLD)
-			{
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Room is too cold");
-				gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "Please turn off AC");
-				gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
-			}
-			else
-			{
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "");
-				gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
-				snprintf(strbuf, sizeof(strbuf), "%-21s", "");
-				gfx_mono_draw_string(strbuf, 0, 24, &sysfont);
-			}
+			companion_clock = CLOCK_SCALE_RC32M;
 		}
+		boot_mark(BOOT_STAGE_CLOCK);
+		// time the companion from here on, it runs at 32 MHz meanwhile
+		deadline_register(&companion_monitor);
+		sched_cancel(&bring_up_task);
 	}
 }
+
+int main(void)
+{
+	/* Insert system clock initialization code here (sysclk_init()). */
+
+	// inits
+	board_init();
+	// hold the lcd in reset while the rest is brought up, so its reset
+	// pulse takes no time of its own
+	ioport_set_pin_low(ST7565R_RESET_PIN);
+	sysclk_init();
+	clock_scale_init();
+	sleepmgr_init();
+	pmic_init();
+	// queues for the work interrupts defer to the main context, and the
+	// interrupt scheduling set in conf_work.h
+	work_init();
+
+	// start the clock first, the boot milestones are timed on it
+	systime_init();
+	boot_init();
+	// delays sleep on a timer rather than counting cycles
+	sleep_delay_init();
+	// start the RTC32 crystal on the backup domain, the reference for the
+	// clocks and the uptime in seconds, which counts on while the cpu sleeps;
+	// the bring-up task waits for it
+	rtc_clock_init();
+
+	// record or replay sensor inputs, if configured in conf_trace.h
+	trace_init();
+	// interrupt latency histograms, if configured in conf_isr_prof.h
+	isr_prof_init();
+	// users of each peripheral clock, printed on the console if configured
+	// in conf_power_gate.h
+	power_gate_init();
+	// run time monitor, resets through the watchdog if configured in
+	// conf_deadline.h
+	deadline_init();
+
+	// setup adc
+	// the first conversions warm the adc up while the rest is brought up,
+	// and their results are ready for the first run of the companion
+	adc_sensors_init();
+	lightsensor_measure();
+	ntc_measure();
+
+	// release the lcd from reset and clear it
+	ioport_set_pin_high(ST7565R_RESET_PIN);
+	gfx_mono_init();
+	clock_scale_register(&lcd_clock_notifier);
+	boot_mark(BOOT_STAGE_DISPLAY);
+
+	// setup timers
+	sched_init();
+	// time spent in each sleep mode and what woke the cpu, printed on the
+	// console if configured in conf_sleep_stats.h
+	sleep_stats_init();
+	soft_timer_init();
+	// cpu load from the time spent idle, shown on the display or printed on
+	// the console if configured in conf_cpu_load.h
+	cpu_load_init();
+	button_init();
+	sound_init();
+	cpu_irq_enable();
+
+	sensor_stats_init(&light_stats, stats_window_length, rtc_clock_get_uptime());
+	sensor_stats_init(&temp_stats, stats_window_length, rtc_clock_get_uptime());
+#ifdef CONFIG_SENSOR_STATS_CONSOLE
+	// summaries printed on the console when 'a' is received
+	console_init();
+	console_register_command('a', print_stats);
+#endif
+
+	// turn on lcd
+	// the backlight is dimmed with the ambient light, and the display sleeps
+	// when no button is pressed and no alert is raised for a while
+	display_power_init();
+
+	// print name and skeleton
+	gfx_mono_draw_string("Coding Companion", 0, 0, &sysfont);
+	gfx_mono_draw_string("L    0lx  S 0h  T  0c", 0, 8, &sysfont);
+
+	// run the companion from the scheduler, the cpu sleeps in between; the
+	// rtc and the 32 MHz clock are brought up alongside it
+	sched_start(&companion_task, 0, SCHED_MS(COMPANION_PERIOD_MS));
+	sched_start(&bring_up_task, 0, SCHED_MS(BRING_UP_PERIOD_MS));
+	boot_mark(BOOT_STAGE_SCHED);
+	sched_run();
+}
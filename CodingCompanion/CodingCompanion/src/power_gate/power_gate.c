@@ -0,0 +1,127 @@
+/**
+ * \file
+ *
+ * \brief Reference counted peripheral power reduction
+ *
+ */
+#include <asf.h>
+#include <console/console.h>
+#include "power_gate.h"
+
+//! \internal Power reduction register of \a port
+#define POWER_GATE_PR(port) (*((uint8_t *)&PR.PRGEN + (port)))
+
+//! \internal Name of each power reduction register on the console
+static const char power_gate_port_name[POWER_GATE_NR_OF_PORTS] = {
+	'G', 'A', 'B', 'C', 'D', 'E', 'F',
+};
+
+/**
+ * \internal
+ * \brief Users of each bit of each power reduction register
+ *
+ * Zero before main(), which matches sysclk_init() stopping every clock.
+ */
+static uint8_t power_gate_count[POWER_GATE_NR_OF_PORTS][8];
+
+/**
+ * \brief Register the console command
+ *
+ * The counts need no initialization, this only exists for the console.
+ */
+void power_gate_init(void)
+{
+#ifdef CONFIG_POWER_GATE_CONSOLE
+	console_init();
+	console_register_command('g', power_gate_dump);
+#endif
+}
+
+/**
+ * \brief Take a reference on peripheral clocks
+ *
+ * Safe to call from interrupts.
+ *
+ * \param port the power reduction register, an enum sysclk_port_id
+ * \param mask the bits of the modules, e.g. SYSCLK_TC0 | SYSCLK_HIRES
+ */
+void power_gate_acquire(uint8_t port, uint8_t mask)
+{
+	uint8_t *count = power_gate_count[port];
+	irqflags_t flags;
+
+	Assert(port < POWER_GATE_NR_OF_PORTS);
+
+	flags = cpu_irq_save();
+	for (uint8_t bit = 0; bit < 8; bit++) {
+		if (mask & (1 << bit)) {
+			Assert(count[bit] < 0xff);
+			count[bit]++;
+		}
+	}
+	POWER_GATE_PR(port) &= ~mask;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Drop a reference on peripheral clocks
+ *
+ * The clock of each module whose last reference this was is stopped. Safe
+ * to call from interrupts.
+ *
+ * \param port the power reduction register, an enum sysclk_port_id
+ * \param mask the bits of the modules, as given to power_gate_acquire()
+ */
+void power_gate_release(uint8_t port, uint8_t mask)
+{
+	uint8_t *count = power_gate_count[port];
+	uint8_t stop = 0;
+	irqflags_t flags;
+
+	Assert(port < POWER_GATE_NR_OF_PORTS);
+
+	flags = cpu_irq_save();
+	for (uint8_t bit = 0; bit < 8; bit++) {
+		if (mask & (1 << bit)) {
+			Assert(count[bit]);
+			if (!--count[bit]) {
+				stop |= 1 << bit;
+			}
+		}
+	}
+	POWER_GATE_PR(port) |= stop;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Get the number of users of a peripheral clock
+ *
+ * \param port the power reduction register, an enum sysclk_port_id
+ * \param bit the bit number of the module in the register
+ */
+uint8_t power_gate_get_count(uint8_t port, uint8_t bit)
+{
+	Assert(port < POWER_GATE_NR_OF_PORTS);
+	Assert(bit < 8);
+
+	return power_gate_count[port][bit];
+}
+
+/**
+ * \brief Print the registers and counts on the console
+ *
+ * One line per register with its name, its value in hex, where a set bit
+ * is a stopped clock, and the counts of bits 7 down to 0.
+ */
+void power_gate_dump(void)
+{
+	for (uint8_t port = 0; port < POWER_GATE_NR_OF_PORTS; port++) {
+		const uint8_t *count = power_gate_count[port];
+
+		console_printf("G %c %02x %u %u %u %u %u %u %u %u\r\n",
+				power_gate_port_name[port], POWER_GATE_PR(port),
+				count[7], count[6], count[5], count[4],
+				count[3], count[2], count[1], count[0]);
+	}
+	console_puts("G end\r\n");
+}
@@ -0,0 +1,34 @@
+/**
+ * \file
+ *
+ * \brief Reference counted peripheral power reduction
+ *
+ * Counts the users of every bit of the power reduction registers, so a
+ * peripheral clock that is shared, like the high-resolution extension of
+ * two timers or the event system, runs exactly as long as anyone uses it.
+ * The clock of a module is started by its first power_gate_acquire() and
+ * stopped when the last user calls power_gate_release().
+ *
+ * sysclk_enable_module() and sysclk_disable_module() are routed here by
+ * conf_clock.h, so every driver that pairs them is counted without changes,
+ * and a module is acquired for as long as its driver is enabled.
+ *
+ * With CONFIG_POWER_GATE_CONSOLE the registers and counts are printed on
+ * the console with the 'g' command, see console_poll().
+ */
+#ifndef POWER_GATE_H_INCLUDED
+#define POWER_GATE_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_power_gate.h>
+
+//! Number of power reduction registers, SYSCLK_PORT_GEN to SYSCLK_PORT_F
+#define POWER_GATE_NR_OF_PORTS 7
+
+void power_gate_init(void);
+void power_gate_acquire(uint8_t port, uint8_t mask);
+void power_gate_release(uint8_t port, uint8_t mask);
+uint8_t power_gate_get_count(uint8_t port, uint8_t bit);
+void power_gate_dump(void);
+
+#endif /* POWER_GATE_H_INCLUDED */
@@ -0,0 +1,258 @@
+/**
+ * \file
+ *
+ * \brief Buffered PWM on the timer counters
+ *
+ */
+#include <asf.h>
+#include "pwm.h"
+
+//! \internal Port, pins and hi-res extension of a timer counter
+struct pwm_tc_info {
+	volatile void *tc;
+	PORT_t *port;
+	//! Pin of channel A
+	uint8_t pin;
+	//! Number of compare channels
+	uint8_t nr_of_channels;
+	HIRES_t *hires;
+	//! Hi-res enable bits of the timer counter
+	uint8_t hren;
+};
+
+//! \internal Timer counters that can drive PWM pins
+static const struct pwm_tc_info pwm_tc_info[] = {
+#ifdef TCC0
+	{&TCC0, &PORTC, 0, 4, &HIRESC, HIRES_HREN_TC0_gc},
+#endif
+#ifdef TCC1
+	{&TCC1, &PORTC, 4, 2, &HIRESC, HIRES_HREN_TC1_gc},
+#endif
+#ifdef TCD0
+	{&TCD0, &PORTD, 0, 4, &HIRESD, HIRES_HREN_TC0_gc},
+#endif
+#ifdef TCD1
+	{&TCD1, &PORTD, 4, 2, &HIRESD, HIRES_HREN_TC1_gc},
+#endif
+#ifdef TCE0
+	{&TCE0, &PORTE, 0, 4, &HIRESE, HIRES_HREN_TC0_gc},
+#endif
+#ifdef TCE1
+	{&TCE1, &PORTE, 4, 2, &HIRESE, HIRES_HREN_TC1_gc},
+#endif
+#ifdef TCF0
+	{&TCF0, &PORTF, 0, 4, &HIRESF, HIRES_HREN_TC0_gc},
+#endif
+};
+#define PWM_NR_OF_TCS (sizeof(pwm_tc_info) / sizeof(pwm_tc_info[0]))
+
+//! \internal Prescalers of the timer counters, from the smallest
+static const struct {
+	uint16_t div;
+	TC_CLKSEL_t clksel;
+} pwm_prescalers[] = {
+	{1, TC_CLKSEL_DIV1_gc},
+	{2, TC_CLKSEL_DIV2_gc},
+	{4, TC_CLKSEL_DIV4_gc},
+	{8, TC_CLKSEL_DIV8_gc},
+	{64, TC_CLKSEL_DIV64_gc},
+	{256, TC_CLKSEL_DIV256_gc},
+	{1024, TC_CLKSEL_DIV1024_gc},
+};
+#define PWM_NR_OF_PRESCALERS \
+	(sizeof(pwm_prescalers) / sizeof(pwm_prescalers[0]))
+
+/**
+ * \internal
+ * \brief Look up the port and pins of a timer counter
+ *
+ * \retval NULL if the timer counter has no PWM pins
+ */
+static const struct pwm_tc_info *pwm_get_tc_info(volatile void *tc)
+{
+	for (uint8_t i = 0; i < PWM_NR_OF_TCS; i++) {
+		if (pwm_tc_info[i].tc == tc) {
+			return &pwm_tc_info[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \brief Initialize a PWM timer
+ *
+ * Picks the smallest prescaler that fits the period in the timer, for the
+ * finest duty cycle steps. The timer is left stopped with all channels
+ * disabled.
+ *
+ * With the hi-res extension the timer counts four steps per peripheral
+ * clock, so \a period is four times larger. This needs the timer to run
+ * without prescaling and clkPER4 to be four times clkPER, that is
+ * CONFIG_SYSCLK_PSBCDIV set to SYSCLK_PSBCDIV_2_2.
+ *
+ * \param pwm the PWM timer to initialize
+ * \param tc the timer counter
+ * \param freq_hz the PWM frequency
+ * \param hires whether to use the hi-res extension
+ *
+ * \retval STATUS_OK if the timer was set up
+ * \retval ERR_INVALID_ARG if the timer has no PWM pins or the frequency is
+ * out of its range
+ * \retval ERR_UNSUPPORTED_DEV if hi-res is asked for but the clocks do not
+ * allow it
+ */
+status_code_t pwm_init(struct pwm *pwm, volatile void *tc, uint32_t freq_hz,
+		bool hires)
+{
+	const struct pwm_tc_info *info = pwm_get_tc_info(tc);
+	uint32_t counts;
+	uint8_t i = 0;
+
+	if (!info || !freq_hz) {
+		return ERR_INVALID_ARG;
+	}
+
+	counts = sysclk_get_per_hz() / freq_hz;
+	if (hires) {
+		if (sysclk_get_per4_hz() != 4 * sysclk_get_per_hz()) {
+			return ERR_UNSUPPORTED_DEV;
+		}
+		counts *= 4;
+	} else {
+		while (i < PWM_NR_OF_PRESCALERS - 1
+				&& counts / pwm_prescalers[i].div > 0xffff) {
+			i++;
+		}
+		counts /= pwm_prescalers[i].div;
+	}
+	if (counts < 2 || counts > 0xffff) {
+		return ERR_INVALID_ARG;
+	}
+
+	pwm->tc = tc;
+	pwm->period = counts;
+	pwm->channels = 0;
+	pwm->clksel = pwm_prescalers[i].clksel;
+
+	tc_enable(tc);
+	tc_write_clock_source(tc, TC_CLKSEL_OFF_gc);
+	tc_set_wgm(tc, TC_WG_SS);
+	/* A compare value past the top never matches, so a duty cycle of
+	 * one full period keeps the output high. */
+	tc_write_period(tc, counts - 1);
+	tc_write_count(tc, 0);
+
+	/* tc_enable() clocks the hi-res extension along with the timer, and
+	 * tc_disable() stops it again once no timer of the port uses it */
+	if (hires) {
+		tc_hires_set_mode(info->hires, info->hires->CTRLA | info->hren);
+	} else {
+		tc_hires_set_mode(info->hires, info->hires->CTRLA & ~info->hren);
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Enable a channel and its output pin
+ *
+ * The channel starts at duty cycle 0.
+ *
+ * \param pwm the PWM timer
+ * \param channel the channel, TC_CCA or TC_CCB on a type 1 timer
+ */
+void pwm_enable_channel(struct pwm *pwm, enum tc_cc_channel_t channel)
+{
+	const struct pwm_tc_info *info = pwm_get_tc_info(pwm->tc);
+	uint8_t index = channel - TC_CCA;
+
+	Assert(index < info->nr_of_channels);
+
+	tc_write_cc(pwm->tc, channel, 0);
+	tc_write_cc_buffer(pwm->tc, channel, 0);
+	tc_enable_cc_channels(pwm->tc,
+			(enum tc_cc_channel_mask_enable_t)(TC_CCAEN << index));
+	pwm->channels |= 1 << index;
+
+	info->port->OUTCLR = 1 << (info->pin + index);
+	info->port->DIRSET = 1 << (info->pin + index);
+}
+
+/**
+ * \brief Disable a channel and release its output pin
+ *
+ * \param pwm the PWM timer
+ * \param channel the channel
+ */
+void pwm_disable_channel(struct pwm *pwm, enum tc_cc_channel_t channel)
+{
+	const struct pwm_tc_info *info = pwm_get_tc_info(pwm->tc);
+	uint8_t index = channel - TC_CCA;
+
+	tc_disable_cc_channels(pwm->tc,
+			(enum tc_cc_channel_mask_enable_t)(TC_CCAEN << index));
+	pwm->channels &= ~(1 << index);
+
+	info->port->DIRCLR = 1 << (info->pin + index);
+}
+
+/**
+ * \brief Start the PWM timer
+ *
+ * \param pwm the PWM timer
+ */
+void pwm_start(struct pwm *pwm)
+{
+	tc_write_clock_source(pwm->tc, pwm->clksel);
+}
+
+/**
+ * \brief Stop the PWM timer
+ *
+ * The outputs stay at the level they had.
+ *
+ * \param pwm the PWM timer
+ */
+void pwm_stop(struct pwm *pwm)
+{
+	tc_write_clock_source(pwm->tc, TC_CLKSEL_OFF_gc);
+}
+
+/**
+ * \brief Set up a mapping from an input range to the duty cycles of a timer
+ *
+ * Divides once here, so pwm_map() only needs to multiply and shift. The
+ * reciprocal keeps as many fraction bits as fit in 16 bits, which leaves the
+ * mapped duty cycle at most one count short of the exact one.
+ *
+ * \param map the mapping to set up
+ * \param pwm the PWM timer the duty cycles are for
+ * \param in_min the input mapped to duty cycle 0
+ * \param in_max the input mapped to a full period
+ */
+void pwm_map_init(struct pwm_map *map, const struct pwm *pwm,
+		uint16_t in_min, uint16_t in_max)
+{
+	uint32_t scale;
+	uint8_t shift = 16;
+
+	map->in_min = in_min;
+	map->in_max = in_max;
+	map->full = pwm->period;
+
+	if (in_max <= in_min) {
+		/* No range, every input is at one of the ends */
+		map->in_max = in_min;
+		map->scale = 0;
+		map->shift = 0;
+		return;
+	}
+
+	scale = ((uint32_t)pwm->period << 16) / (uint16_t)(in_max - in_min);
+	while (scale > 0xffff) {
+		scale >>= 1;
+		shift--;
+	}
+	map->scale = scale;
+	map->shift = shift;
+}
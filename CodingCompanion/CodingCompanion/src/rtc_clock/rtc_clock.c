@@ -0,0 +1,459 @@
+/**
+ * \file
+ *
+ * \brief RTC32 clock on the backup domain crystal
+ *
+ */
+#include <asf.h>
+#include <systime/systime.h>
+#include <sleep_delay/sleep_delay.h>
+#include <sleep_stats/sleep_stats.h>
+#include "rtc_clock.h"
+
+//! \internal Crystal output selected for the RTC
+#ifdef CONFIG_RTC_CLOCK_1024HZ
+#  define RTC_CLOCK_XOSCSEL  VBAT_XOSCSEL_bm
+#else
+#  define RTC_CLOCK_XOSCSEL  0
+#endif
+
+/**
+ * \internal
+ * \brief Shortest distance at which an RTC compare is known to be ahead
+ *
+ * Covers the synchronization of a count read, which takes up to two RTC
+ * clock cycles.
+ */
+#define RTC_CLOCK_COMPARE_MARGIN 4
+
+//! \internal Steps of bringing up a reset backup domain
+enum rtc_clock_state {
+	//! Waiting for the crystal to start
+	RTC_CLOCK_STATE_CRYSTAL,
+	//! Waiting for the RTC to stop
+	RTC_CLOCK_STATE_STOP,
+	//! Waiting for the period and count to be loaded
+	RTC_CLOCK_STATE_LOAD,
+	//! Waiting for the RTC to start
+	RTC_CLOCK_STATE_START,
+	//! Counting
+	RTC_CLOCK_STATE_READY,
+};
+
+static enum rtc_clock_state rtc_clock_state;
+
+//! \internal Steps of a measurement on the compare channel
+enum rtc_clock_measure_state {
+	//! No measurement, the compare channel counts the seconds
+	RTC_CLOCK_MEASURE_IDLE,
+	//! Waiting for the compare that starts the measurement
+	RTC_CLOCK_MEASURE_START,
+	//! Waiting for the compare that ends it
+	RTC_CLOCK_MEASURE_END,
+	//! Done, waiting for rtc_clock_measure_poll() to hand the channel back
+	RTC_CLOCK_MEASURE_DONE,
+};
+
+static volatile enum rtc_clock_measure_state rtc_clock_measure_state;
+//! \internal RTC ticks the running measurement times
+static uint16_t rtc_clock_measure_ticks;
+//! \internal Monotonic clock at the start, then the measured microseconds
+static volatile uint32_t rtc_clock_measure_us;
+
+//! \internal Seconds counted since the RTC was ready
+static volatile uint32_t rtc_clock_uptime;
+//! \internal RTC count at which the next second starts
+static uint32_t rtc_clock_next_second;
+//! \internal Wall clock time at an uptime of 0
+static uint32_t rtc_clock_time_base;
+//! \internal Running alarms, in no particular order
+static struct rtc_clock_alarm *rtc_clock_alarms;
+
+/**
+ * \internal
+ * \brief Check whether writes to the RTC have crossed into its clock domain
+ */
+static bool rtc_clock_is_synced(void)
+{
+	return !(RTC32.SYNCCTRL & RTC32_SYNCBUSY_bm);
+}
+
+/**
+ * \internal
+ * \brief Set the compare for the start of the next second and enable it
+ *
+ * Seconds that went by since the last one counted are counted now, so the
+ * compare is always ahead of the count.
+ */
+static void rtc_clock_resume_seconds(void)
+{
+	uint32_t count = rtc_clock_get_count();
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	while ((int32_t)(rtc_clock_next_second - count)
+			< RTC_CLOCK_COMPARE_MARGIN) {
+		rtc_clock_next_second += RTC_CLOCK_TICKS_PER_SEC;
+		rtc_clock_uptime++;
+	}
+	RTC32.COMP = rtc_clock_next_second;
+	RTC32.INTFLAGS = RTC32_COMPIF_bm;
+	RTC32.INTCTRL = RTC32_COMPINTLVL_LO_gc;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \internal
+ * \brief Start counting seconds from now
+ */
+static void rtc_clock_start_seconds(void)
+{
+	rtc_clock_uptime = 0;
+	rtc_clock_next_second = rtc_clock_get_count() + RTC_CLOCK_TICKS_PER_SEC;
+	rtc_clock_state = RTC_CLOCK_STATE_READY;
+	rtc_clock_resume_seconds();
+}
+
+/**
+ * \internal
+ * \brief Get a running alarm that has expired
+ *
+ * \retval NULL if none has
+ */
+static struct rtc_clock_alarm *rtc_clock_get_expired(void)
+{
+	struct rtc_clock_alarm *alarm;
+
+	for (alarm = rtc_clock_alarms; alarm; alarm = alarm->next) {
+		if ((int32_t)(alarm->expires - rtc_clock_uptime) <= 0) {
+			break;
+		}
+	}
+	return alarm;
+}
+
+/**
+ * \internal
+ * \brief Remove an alarm from the list of running alarms
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void rtc_clock_unlink(struct rtc_clock_alarm *alarm)
+{
+	struct rtc_clock_alarm **link = &rtc_clock_alarms;
+
+	if (!alarm->running) {
+		return;
+	}
+	while (*link != alarm) {
+		link = &(*link)->next;
+	}
+	*link = alarm->next;
+	alarm->running = false;
+}
+
+/**
+ * \internal
+ * \brief Take the monotonic clock at an end of a measurement
+ *
+ * The channel is left disabled after the last end, so the seconds are only
+ * resumed from rtc_clock_measure_poll(), which may wait for a count read.
+ */
+static void rtc_clock_measure_edge(void)
+{
+	uint32_t now = systime_now();
+
+	if (rtc_clock_measure_state == RTC_CLOCK_MEASURE_START) {
+		rtc_clock_measure_us = now;
+		RTC32.COMP += rtc_clock_measure_ticks;
+		rtc_clock_measure_state = RTC_CLOCK_MEASURE_END;
+	} else {
+		rtc_clock_measure_us = now - rtc_clock_measure_us;
+		RTC32.INTCTRL = RTC32_COMPINTLVL_OFF_gc;
+		rtc_clock_measure_state = RTC_CLOCK_MEASURE_DONE;
+	}
+}
+
+/**
+ * \internal
+ * \brief Interrupt at the start of each second
+ *
+ * Counts the second and runs the alarms that expire with it. A periodic
+ * alarm that fell behind skips the periods it missed. While a measurement
+ * borrows the channel, it takes the ends of the measurement instead.
+ */
+ISR(RTC32_COMP_vect)
+{
+	struct rtc_clock_alarm *alarm;
+
+	sleep_stats_wakeup(SLEEP_STATS_RTC);
+	if ((rtc_clock_measure_state == RTC_CLOCK_MEASURE_START)
+			|| (rtc_clock_measure_state == RTC_CLOCK_MEASURE_END)) {
+		rtc_clock_measure_edge();
+		return;
+	}
+	rtc_clock_next_second += RTC_CLOCK_TICKS_PER_SEC;
+	RTC32.COMP = rtc_clock_next_second;
+	rtc_clock_uptime++;
+
+	while ((alarm = rtc_clock_get_expired())) {
+		if (alarm->period) {
+			alarm->expires += alarm->period;
+			if ((int32_t)(alarm->expires - rtc_clock_uptime) <= 0) {
+				alarm->expires = rtc_clock_uptime + alarm->period;
+			}
+		} else {
+			rtc_clock_unlink(alarm);
+		}
+		alarm->callback();
+	}
+}
+
+/**
+ * \internal
+ * \brief Check whether the backup domain kept its power and its crystal
+ */
+static bool rtc_clock_backup_is_valid(void)
+{
+	uint8_t status = VBAT.STATUS;
+
+	if (status & (VBAT_BBPORF_bm | VBAT_BBBORF_bm | VBAT_BBPWR_bm)) {
+		return false;
+	}
+	if (!(status & VBAT_XOSCRDY_bm) || (status & VBAT_XOSCFAIL_bm)) {
+		return false;
+	}
+	return (VBAT.CTRL & VBAT_XOSCSEL_bm) == RTC_CLOCK_XOSCSEL
+			&& (RTC32.CTRL & RTC32_ENABLE_bm);
+}
+
+/**
+ * \brief Start the RTC
+ *
+ * The backup domain and the count are reset only if the domain is not
+ * running as configured, otherwise the RTC is left counting. A reset domain
+ * waits up to a second for its crystal, so this only starts the crystal and
+ * rtc_clock_poll() finishes the bring-up. The uptime counts from when the
+ * RTC is ready.
+ */
+void rtc_clock_init(void)
+{
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_RTC);
+	VBAT.CTRL |= VBAT_ACCEN_bm;
+
+	rtc_clock_alarms = NULL;
+	rtc_clock_time_base = 0;
+	rtc_clock_measure_state = RTC_CLOCK_MEASURE_IDLE;
+
+	if (rtc_clock_backup_is_valid()) {
+		rtc_clock_start_seconds();
+		return;
+	}
+
+	ccp_write_io((void *)&VBAT.CTRL, VBAT_RESET_bm);
+	VBAT.CTRL |= VBAT_XOSCFDEN_bm;
+	/* Let the supply of the backup domain settle */
+	sleep_delay_us(200);
+	VBAT.CTRL |= VBAT_XOSCEN_bm | RTC_CLOCK_XOSCSEL;
+	rtc_clock_state = RTC_CLOCK_STATE_CRYSTAL;
+}
+
+/**
+ * \brief Advance the bring-up of the RTC
+ *
+ * Takes the next step once the crystal has started or the previous write
+ * has been synchronized, and never waits for either.
+ *
+ * \retval true if the RTC is counting
+ * \retval false if it is still being brought up
+ */
+bool rtc_clock_poll(void)
+{
+	if ((rtc_clock_state == RTC_CLOCK_STATE_READY) || !rtc_clock_is_synced()) {
+		return rtc_clock_state == RTC_CLOCK_STATE_READY;
+	}
+
+	switch (rtc_clock_state) {
+	case RTC_CLOCK_STATE_CRYSTAL:
+		if (VBAT.STATUS & VBAT_XOSCRDY_bm) {
+			RTC32.CTRL = 0;
+			rtc_clock_state = RTC_CLOCK_STATE_STOP;
+		}
+		break;
+
+	case RTC_CLOCK_STATE_STOP:
+		RTC32.PER = 0xffffffff;
+		RTC32.CNT = 0;
+		rtc_clock_state = RTC_CLOCK_STATE_LOAD;
+		break;
+
+	case RTC_CLOCK_STATE_LOAD:
+		RTC32.INTCTRL = 0;
+		RTC32.CTRL = RTC32_ENABLE_bm;
+		rtc_clock_state = RTC_CLOCK_STATE_START;
+		break;
+
+	default:
+		rtc_clock_start_seconds();
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * \brief Read the RTC count
+ *
+ * Waits for the count to be synchronized, up to two RTC clock cycles.
+ *
+ * \note Only valid once rtc_clock_poll() has returned true.
+ *
+ * \retval RTC ticks since the backup domain was reset
+ */
+uint32_t rtc_clock_get_count(void)
+{
+	RTC32.SYNCCTRL |= RTC32_SYNCCNT_bm;
+	while (RTC32.SYNCCTRL & RTC32_SYNCCNT_bm) {
+	}
+	return RTC32.CNT;
+}
+
+/**
+ * \brief Start timing a number of RTC ticks on the monotonic clock
+ *
+ * Borrows the compare channel of the RTC and returns right away. Both ends
+ * are taken from the compare interrupt, which follows the tick with the
+ * same delay every time, so the measurement is neither blurred by the
+ * synchronization of count reads nor by how often rtc_clock_measure_poll()
+ * is called. The interrupt runs at high level for the measurement, so lower
+ * level interrupts do not delay the ends either.
+ *
+ * \note Only valid once rtc_clock_poll() has returned true, and with no
+ * other measurement running.
+ *
+ * \param ticks RTC ticks to time, at least 1
+ */
+void rtc_clock_measure_start(uint16_t ticks)
+{
+	Assert(ticks);
+	Assert(rtc_clock_state == RTC_CLOCK_STATE_READY);
+	Assert(rtc_clock_measure_state == RTC_CLOCK_MEASURE_IDLE);
+
+	RTC32.INTCTRL = RTC32_COMPINTLVL_OFF_gc;
+	rtc_clock_measure_ticks = ticks;
+	rtc_clock_measure_state = RTC_CLOCK_MEASURE_START;
+	RTC32.COMP = rtc_clock_get_count() + RTC_CLOCK_COMPARE_MARGIN;
+	RTC32.INTFLAGS = RTC32_COMPIF_bm;
+	RTC32.INTCTRL = RTC32_COMPINTLVL_HI_gc;
+}
+
+/**
+ * \brief Check whether the measurement has ended
+ *
+ * Once it has, the compare channel is handed back. The seconds that passed
+ * meanwhile are counted then, and their alarms run on the next second.
+ *
+ * \param us where to store the microseconds the system clock counted during
+ * the ticks
+ *
+ * \retval true if the measurement ended and \a us was stored
+ * \retval false if it is still running
+ */
+bool rtc_clock_measure_poll(uint32_t *us)
+{
+	if (rtc_clock_measure_state != RTC_CLOCK_MEASURE_DONE) {
+		return false;
+	}
+
+	*us = rtc_clock_measure_us;
+	rtc_clock_measure_state = RTC_CLOCK_MEASURE_IDLE;
+	rtc_clock_resume_seconds();
+
+	return true;
+}
+
+/**
+ * \brief Get the seconds counted since the RTC was ready
+ *
+ * Counts on in power-save sleep, and wraps after 136 years.
+ */
+uint32_t rtc_clock_get_uptime(void)
+{
+	irqflags_t flags;
+	uint32_t uptime;
+
+	flags = cpu_irq_save();
+	uptime = rtc_clock_uptime;
+	cpu_irq_restore(flags);
+
+	return uptime;
+}
+
+/**
+ * \brief Get the wall clock time
+ *
+ * \retval seconds since the epoch given to rtc_clock_set_time(), or the
+ * uptime if the time was not set since the device was reset
+ */
+uint32_t rtc_clock_get_time(void)
+{
+	return rtc_clock_time_base + rtc_clock_get_uptime();
+}
+
+/**
+ * \brief Set the wall clock time
+ *
+ * Only the offset from the uptime is kept, alarms run on the uptime and are
+ * not moved.
+ *
+ * \param time seconds since an epoch of the caller's choice
+ */
+void rtc_clock_set_time(uint32_t time)
+{
+	rtc_clock_time_base = time - rtc_clock_get_uptime();
+}
+
+/**
+ * \brief Start an alarm
+ *
+ * An alarm that is already running is restarted. Safe to call from
+ * interrupts and from alarm callbacks.
+ *
+ * \param alarm the alarm, with \a callback set
+ * \param delay seconds until the first expiry, at least 1
+ * \param period seconds between expiries, 0 to expire only once
+ */
+void rtc_clock_alarm_start(struct rtc_clock_alarm *alarm, uint32_t delay,
+		uint32_t period)
+{
+	irqflags_t flags;
+
+	Assert(alarm->callback);
+	Assert(delay);
+
+	flags = cpu_irq_save();
+	rtc_clock_unlink(alarm);
+	alarm->expires = rtc_clock_uptime + delay;
+	alarm->period = period;
+	alarm->next = rtc_clock_alarms;
+	rtc_clock_alarms = alarm;
+	alarm->running = true;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Stop an alarm
+ *
+ * Does nothing if the alarm is not running. Safe to call from interrupts
+ * and from alarm callbacks.
+ *
+ * \param alarm the alarm
+ */
+void rtc_clock_alarm_cancel(struct rtc_clock_alarm *alarm)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	rtc_clock_unlink(alarm);
+	cpu_irq_restore(flags);
+}
@@ -0,0 +1,67 @@
+/**
+ * \file
+ *
+ * \brief RTC32 clock on the backup domain crystal
+ *
+ * Runs the 32-bit RTC of the battery backup domain from its 32.768 kHz
+ * crystal. The backup domain is only reset when it lost power or its
+ * crystal failed, so the count survives a reset of the device. The crystal
+ * of a reset domain takes up to a second to start, rtc_clock_poll() is
+ * called until it returns true before the count is used.
+ *
+ * The crystal is independent of every oscillator the system clock runs on,
+ * which makes the RTC the reference rtc_clock_measure_start() times the
+ * system clock against.
+ *
+ * Once counting, the compare channel interrupts once a second to keep the
+ * uptime in seconds and to run the alarms. The RTC keeps counting and
+ * interrupting in power-save sleep, so long intervals are tracked while the
+ * system clock is stopped.
+ */
+#ifndef RTC_CLOCK_H_INCLUDED
+#define RTC_CLOCK_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_rtc_clock.h>
+
+//! RTC ticks per second
+#ifdef CONFIG_RTC_CLOCK_1024HZ
+#  define RTC_CLOCK_TICKS_PER_SEC  1024UL
+#else
+#  define RTC_CLOCK_TICKS_PER_SEC  32768UL
+#endif
+
+//! Alarm callback, runs in interrupt context
+typedef void (*rtc_clock_alarm_callback_t)(void);
+
+/**
+ * \brief Alarm descriptor
+ *
+ * Owned by the caller. Only \a callback is set by the caller, the rest is
+ * private to the clock.
+ */
+struct rtc_clock_alarm {
+	rtc_clock_alarm_callback_t callback;
+	//! Next running alarm
+	struct rtc_clock_alarm *next;
+	//! Uptime at which the alarm expires
+	uint32_t expires;
+	//! Seconds between expiries, 0 for a one-shot alarm
+	uint32_t period;
+	//! Whether the alarm is in the list of running alarms
+	bool running;
+};
+
+void rtc_clock_init(void);
+bool rtc_clock_poll(void);
+uint32_t rtc_clock_get_count(void);
+void rtc_clock_measure_start(uint16_t ticks);
+bool rtc_clock_measure_poll(uint32_t *us);
+uint32_t rtc_clock_get_uptime(void);
+uint32_t rtc_clock_get_time(void);
+void rtc_clock_set_time(uint32_t time);
+void rtc_clock_alarm_start(struct rtc_clock_alarm *alarm, uint32_t delay,
+		uint32_t period);
+void rtc_clock_alarm_cancel(struct rtc_clock_alarm *alarm);
+
+#endif /* RTC_CLOCK_H_INCLUDED */
@@ -0,0 +1,190 @@
+/**
+ * \file
+ *
+ * \brief Tickless cooperative task scheduler
+ *
+ */
+#include <asf.h>
+#include <sleep_stats/sleep_stats.h>
+#include <cpu_load/cpu_load.h>
+#include <work/work.h>
+#include "sched.h"
+
+//! \internal Started tasks, sorted by deadline
+static struct sched_task *sched_queue;
+
+/**
+ * \internal
+ * \brief Callback for the scheduler alarm
+ *
+ * Only wakes the CPU; the due task runs in sched_run().
+ */
+static void sched_alarm_handler(void)
+{
+}
+
+/**
+ * \internal
+ * \brief Check whether \a deadline has been reached at \a now
+ */
+static inline bool sched_is_due(uint32_t deadline, uint32_t now)
+{
+	return (int32_t)(deadline - now) <= 0;
+}
+
+/**
+ * \internal
+ * \brief Insert a task in deadline order
+ *
+ * Tasks with the same deadline run in the order they were started.
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void sched_insert(struct sched_task *task)
+{
+	struct sched_task **link = &sched_queue;
+
+	while (*link && !((int32_t)(task->deadline - (*link)->deadline) < 0)) {
+		link = &(*link)->next;
+	}
+	task->next = *link;
+	*link = task;
+	task->queued = true;
+}
+
+/**
+ * \internal
+ * \brief Remove a task from the queue if it is in it
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void sched_remove(struct sched_task *task)
+{
+	struct sched_task **link = &sched_queue;
+
+	if (!task->queued) {
+		return;
+	}
+	while (*link != task) {
+		link = &(*link)->next;
+	}
+	*link = task->next;
+	task->queued = false;
+}
+
+/**
+ * \internal
+ * \brief Set the alarm for the nearest deadline
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void sched_arm(void)
+{
+	if (sched_queue) {
+		systime_alarm_set(SYSTIME_ALARM_SCHED, sched_queue->deadline);
+	} else {
+		systime_alarm_cancel(SYSTIME_ALARM_SCHED);
+	}
+}
+
+/**
+ * \brief Initialize the scheduler
+ *
+ * \note Runs on the monotonic clock, so systime_init() must be called first.
+ */
+void sched_init(void)
+{
+	sched_queue = NULL;
+	systime_alarm_init(SYSTIME_ALARM_SCHED, sched_alarm_handler);
+}
+
+/**
+ * \brief Start a task
+ *
+ * A task that is already started is rescheduled. Safe to call from
+ * interrupts.
+ *
+ * \param task the task, with \a fn set
+ * \param delay ticks until the first run, 0 to run as soon as possible
+ * \param period ticks between runs, 0 to run only once
+ */
+void sched_start(struct sched_task *task, uint32_t delay, uint32_t period)
+{
+	irqflags_t flags;
+
+	Assert(task->fn);
+
+	flags = cpu_irq_save();
+	sched_remove(task);
+	task->deadline = sched_now() + delay;
+	task->period = period;
+	sched_insert(task);
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Stop a task
+ *
+ * Does nothing if the task is not started. Safe to call from interrupts.
+ *
+ * \param task the task
+ */
+void sched_cancel(struct sched_task *task)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	sched_remove(task);
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Run tasks forever
+ *
+ * Runs each task when its deadline passes, one at a time and in deadline
+ * order. A periodic task that falls behind skips the periods it missed
+ * rather than running back to back. Work deferred by interrupts in work.h
+ * runs first, before each task. With nothing due the CPU sleeps in the
+ * deepest mode the sleep manager allows until the next compare, overflow or
+ * other interrupt, and the sleep is accounted in sleep_stats.h and
+ * cpu_load.h.
+ */
+void sched_run(void)
+{
+	struct sched_task *task;
+	uint32_t now;
+
+	while (1) {
+		cpu_irq_disable();
+		if (work_is_pending()) {
+			cpu_irq_enable();
+			work_run();
+			continue;
+		}
+
+		now = sched_now();
+		task = sched_queue;
+
+		if (!task || !sched_is_due(task->deadline, now)) {
+			/* The alarm fires even if the deadline passes while it
+			 * is being set, so it is safe to sleep on it. */
+			sched_arm();
+			cpu_load_idle_enter();
+			sleep_stats_enter_sleep();
+			cpu_load_idle_exit();
+			continue;
+		}
+
+		sched_remove(task);
+		if (task->period) {
+			task->deadline += task->period;
+			if (sched_is_due(task->deadline, now)) {
+				task->deadline = now + task->period;
+			}
+			sched_insert(task);
+		}
+		cpu_irq_enable();
+
+		task->fn();
+	}
+}
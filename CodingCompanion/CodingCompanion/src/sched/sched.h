@@ -0,0 +1,58 @@
+/**
+ * \file
+ *
+ * \brief Tickless cooperative task scheduler
+ *
+ * Runs periodic and one-shot tasks to completion from the main context. The
+ * scheduler owns one alarm of the monotonic clock and sets it for the nearest
+ * deadline only, so there is no periodic tick interrupt. Between deadlines
+ * sched_run() puts the CPU to sleep through the sleep manager.
+ *
+ * Tasks may be started and cancelled from any context, including interrupts.
+ * An interrupt that only needs its work done as soon as possible posts it to
+ * the queues of work.h instead, which are drained ahead of the tasks.
+ */
+#ifndef SCHED_H_INCLUDED
+#define SCHED_H_INCLUDED
+
+#include <compiler.h>
+#include <systime/systime.h>
+
+//! Scheduler ticks per second, a tick is one microsecond of the clock
+#define SCHED_TICKS_PER_SEC  SYSTIME_TICKS_PER_SEC
+
+//! Convert milliseconds to scheduler ticks
+#define SCHED_MS(ms)  SYSTIME_MS(ms)
+
+//! Task body, runs to completion in the main context
+typedef void (*sched_task_fn_t)(void);
+
+/**
+ * \brief Task descriptor
+ *
+ * Owned by the caller and linked into the scheduler while started. Only
+ * \a fn is set by the caller, the rest is private to the scheduler.
+ */
+struct sched_task {
+	sched_task_fn_t fn;
+	//! Next task in deadline order
+	struct sched_task *next;
+	//! Tick at which the task is due
+	uint32_t deadline;
+	//! Ticks between runs, 0 for a one-shot task
+	uint32_t period;
+	bool queued;
+};
+
+void sched_init(void);
+void sched_start(struct sched_task *task, uint32_t delay, uint32_t period);
+void sched_cancel(struct sched_task *task);
+void sched_run(void);
+
+//! \brief Read the current time in scheduler ticks
+static inline uint32_t sched_now(void)
+{
+	return systime_now();
+}
+
+#endif /* SCHED_H_INCLUDED */
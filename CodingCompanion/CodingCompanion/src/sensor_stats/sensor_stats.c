@@ -0,0 +1,195 @@
+/**
+ * \file
+ *
+ * \brief Windowed sensor statistics
+ *
+ */
+#include <asf.h>
+#include <console/console.h>
+#include "sensor_stats.h"
+
+/**
+ * \internal
+ * \brief Clear the running accumulator of a window
+ */
+static void sensor_stats_window_reset(struct sensor_stats_window *w)
+{
+	w->count = 0;
+	w->min = INT16_MAX;
+	w->max = INT16_MIN;
+	w->sum = 0;
+	w->sum_sq = 0;
+}
+
+/**
+ * \internal
+ * \brief Latch the running accumulator into the window summary
+ *
+ * Mean and variance are only computed here, once per window, so adding a
+ * sample is just a couple of additions and compares.
+ */
+static void sensor_stats_window_latch(struct sensor_stats_window *w)
+{
+	struct sensor_stats_summary *s = &w->last;
+
+	s->count = w->count;
+	if (w->count == 0) {
+		s->min = 0;
+		s->max = 0;
+		s->mean = 0;
+		s->variance = 0;
+		return;
+	}
+
+	s->min = w->min;
+	s->max = w->max;
+	s->mean = (int16_t)(w->sum / (int32_t)w->count);
+	/* var = (sum(x^2) - sum(x)^2 / n) / n */
+	s->variance = (uint32_t)((w->sum_sq - (uint64_t)((int64_t)w->sum
+			* w->sum / w->count)) / w->count);
+}
+
+/**
+ * \internal
+ * \brief Close the window if its time is up
+ *
+ * If more than one window length has passed without any update, the last
+ * complete window was empty and is reported as such.
+ *
+ * \retval true if the window was closed
+ */
+static bool sensor_stats_window_roll(struct sensor_stats_window *w,
+		uint32_t now)
+{
+	uint32_t elapsed = now - w->start;
+
+	if (elapsed < w->length) {
+		return false;
+	}
+
+	if (elapsed < 2 * w->length) {
+		sensor_stats_window_latch(w);
+		w->start += w->length;
+	} else {
+		sensor_stats_window_reset(w);
+		sensor_stats_window_latch(w);
+		w->start = now - (elapsed % w->length);
+	}
+	sensor_stats_window_reset(w);
+	return true;
+}
+
+/**
+ * \brief Initialize the statistics of a channel
+ *
+ * \param stats the channel statistics
+ * \param length length of each window, in ticks
+ * \param now current time, in ticks
+ */
+void sensor_stats_init(struct sensor_stats *stats,
+		const uint32_t length[SENSOR_STATS_NR_OF_WINDOWS], uint32_t now)
+{
+	for (uint8_t i = 0; i < SENSOR_STATS_NR_OF_WINDOWS; i++) {
+		struct sensor_stats_window *w = &stats->window[i];
+
+		Assert(length[i] > 0);
+		w->length = length[i];
+		w->start = now;
+		sensor_stats_window_reset(w);
+		sensor_stats_window_latch(w);
+	}
+}
+
+/**
+ * \brief Close the windows that have ended
+ *
+ * Call this periodically if the channel may go without samples for longer
+ * than its shortest window.
+ *
+ * \param stats the channel statistics
+ * \param now current time, in ticks
+ *
+ * \retval mask of windows that were closed, bit n for window n
+ */
+uint8_t sensor_stats_update(struct sensor_stats *stats, uint32_t now)
+{
+	uint8_t closed = 0;
+
+	for (uint8_t i = 0; i < SENSOR_STATS_NR_OF_WINDOWS; i++) {
+		if (sensor_stats_window_roll(&stats->window[i], now)) {
+			closed |= 1 << i;
+		}
+	}
+	return closed;
+}
+
+/**
+ * \brief Add a sample to all windows of a channel
+ *
+ * Windows that ended before \a now are closed first, so the sample is
+ * accounted to the window it belongs to.
+ *
+ * \param stats the channel statistics
+ * \param sample the sample value
+ * \param now current time, in ticks
+ *
+ * \retval mask of windows that were closed, bit n for window n
+ */
+uint8_t sensor_stats_add(struct sensor_stats *stats, int16_t sample,
+		uint32_t now)
+{
+	uint8_t closed = sensor_stats_update(stats, now);
+
+	for (uint8_t i = 0; i < SENSOR_STATS_NR_OF_WINDOWS; i++) {
+		struct sensor_stats_window *w = &stats->window[i];
+
+		w->count++;
+		if (sample < w->min) {
+			w->min = sample;
+		}
+		if (sample > w->max) {
+			w->max = sample;
+		}
+		w->sum += sample;
+		w->sum_sq += (uint32_t)((int32_t)sample * sample);
+	}
+	return closed;
+}
+
+/**
+ * \brief Get the summary of the last completed window
+ *
+ * \param stats the channel statistics
+ * \param window index of the window
+ * \param summary where to store the summary
+ */
+void sensor_stats_get_summary(const struct sensor_stats *stats,
+		uint8_t window, struct sensor_stats_summary *summary)
+{
+	Assert(window < SENSOR_STATS_NR_OF_WINDOWS);
+	*summary = stats->window[window].last;
+}
+
+/**
+ * \brief Print the summary of the last completed window on the console
+ *
+ * One line "W <name> <length> <count> <min> <max> <mean> <variance>", with
+ * the window length in ticks. The "W" keeps the line apart from the "A"
+ * records of a trace capture.
+ *
+ * \param stats the channel statistics
+ * \param name name of the channel
+ * \param window index of the window
+ */
+void sensor_stats_print(const struct sensor_stats *stats, const char *name,
+		uint8_t window)
+{
+	const struct sensor_stats_window *w;
+
+	Assert(window < SENSOR_STATS_NR_OF_WINDOWS);
+	w = &stats->window[window];
+
+	console_printf("W %s %lu %lu %d %d %d %lu\r\n", name, w->length,
+			w->last.count, w->last.min, w->last.max, w->last.mean,
+			w->last.variance);
+}
@@ -0,0 +1,65 @@
+/**
+ * \file
+ *
+ * \brief Windowed sensor statistics
+ *
+ * Keeps count, min, max, mean and variance of a sensor channel over a number
+ * of tumbling time windows (e.g. 1 s, 1 min and 1 h). Every sample updates all
+ * windows incrementally and memory use is constant, no matter how many
+ * samples a window holds. When a window ends its summary is latched so it can
+ * be reported instead of the raw samples.
+ *
+ * Time is given by the caller in arbitrary ticks, the window lengths must use
+ * the same unit.
+ *
+ * With CONFIG_SENSOR_STATS_CONSOLE the summaries can be printed on the
+ * console with sensor_stats_print().
+ */
+#ifndef SENSOR_STATS_H_INCLUDED
+#define SENSOR_STATS_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_sensor_stats.h>
+
+//! Number of windows tracked per channel
+#define SENSOR_STATS_NR_OF_WINDOWS 3
+
+//! Summary of one completed window
+struct sensor_stats_summary {
+	//! Number of samples in the window, 0 if the window was empty
+	uint32_t count;
+	int16_t min;
+	int16_t max;
+	int16_t mean;
+	//! Population variance, in squared sample units
+	uint32_t variance;
+};
+
+//! \internal Running accumulator of one window
+struct sensor_stats_window {
+	uint32_t length;
+	uint32_t start;
+	uint32_t count;
+	int16_t min;
+	int16_t max;
+	int32_t sum;
+	uint64_t sum_sq;
+	struct sensor_stats_summary last;
+};
+
+//! Statistics of one sensor channel
+struct sensor_stats {
+	struct sensor_stats_window window[SENSOR_STATS_NR_OF_WINDOWS];
+};
+
+void sensor_stats_init(struct sensor_stats *stats,
+		const uint32_t length[SENSOR_STATS_NR_OF_WINDOWS], uint32_t now);
+uint8_t sensor_stats_update(struct sensor_stats *stats, uint32_t now);
+uint8_t sensor_stats_add(struct sensor_stats *stats, int16_t sample,
+		uint32_t now);
+void sensor_stats_get_summary(const struct sensor_stats *stats,
+		uint8_t window, struct sensor_stats_summary *summary);
+void sensor_stats_print(const struct sensor_stats *stats, const char *name,
+		uint8_t window);
+
+#endif /* SENSOR_STATS_H_INCLUDED */
@@ -0,0 +1,139 @@
+/**
+ * \file
+ *
+ * \brief Sleeping delays on a timer counter
+ *
+ */
+#include <asf.h>
+#include "sleep_delay.h"
+
+//! \internal Sleep until the next interrupt, see conf_sleep_delay.h
+#ifndef CONFIG_SLEEP_DELAY_ENTER_SLEEP
+#  define CONFIG_SLEEP_DELAY_ENTER_SLEEP()  sleepmgr_enter_sleep()
+#endif
+
+//! \internal Prescalers of the timer counter, from the smallest
+static const struct {
+	uint16_t div;
+	TC_CLKSEL_t clksel;
+} sleep_delay_prescalers[] = {
+	{1, TC_CLKSEL_DIV1_gc},
+	{8, TC_CLKSEL_DIV8_gc},
+	{64, TC_CLKSEL_DIV64_gc},
+	{256, TC_CLKSEL_DIV256_gc},
+	{1024, TC_CLKSEL_DIV1024_gc},
+};
+#define SLEEP_DELAY_NR_OF_PRESCALERS \
+	(sizeof(sleep_delay_prescalers) / sizeof(sleep_delay_prescalers[0]))
+
+//! \internal Most peripheral clock cycles one timer period can take
+#define SLEEP_DELAY_MAX_TICKS (0x10000UL * 1024)
+
+static volatile bool sleep_delay_expired;
+
+/**
+ * \internal
+ * \brief Callback for the timer overflow, which ends the delay
+ */
+static void sleep_delay_overflow_handler(void)
+{
+	sleep_delay_expired = true;
+}
+
+/**
+ * \internal
+ * \brief Wait for one timer period
+ *
+ * \param ticks peripheral clock cycles to wait, 1 to SLEEP_DELAY_MAX_TICKS
+ */
+static void sleep_delay_period(uint32_t ticks)
+{
+	volatile void *tc = &CONFIG_SLEEP_DELAY_TC;
+	uint8_t i = 0;
+
+	while (i < SLEEP_DELAY_NR_OF_PRESCALERS - 1
+			&& ticks / sleep_delay_prescalers[i].div > 0x10000) {
+		i++;
+	}
+	ticks /= sleep_delay_prescalers[i].div;
+
+	tc_enable(tc);
+	tc_write_period(tc, ticks ? ticks - 1 : 0);
+	tc_write_count(tc, 0);
+	tc_clear_overflow(tc);
+
+	if (cpu_irq_is_enabled()) {
+		sleep_delay_expired = false;
+		tc_set_overflow_interrupt_level(tc, TC_INT_LVL_LO);
+		tc_write_clock_source(tc, sleep_delay_prescalers[i].clksel);
+		/* The flag is checked with interrupts disabled, the sleep
+		 * enables them and sleeps in one step */
+		cpu_irq_disable();
+		while (!sleep_delay_expired) {
+			CONFIG_SLEEP_DELAY_ENTER_SLEEP();
+			cpu_irq_disable();
+		}
+		cpu_irq_enable();
+		tc_set_overflow_interrupt_level(tc, TC_INT_LVL_OFF);
+	} else {
+		tc_write_clock_source(tc, sleep_delay_prescalers[i].clksel);
+		while (!tc_is_overflow(tc)) {
+		}
+	}
+
+	tc_write_clock_source(tc, TC_CLKSEL_OFF_gc);
+	tc_disable(tc);
+}
+
+/**
+ * \internal
+ * \brief Wait for a number of peripheral clock cycles
+ */
+static void sleep_delay_ticks(uint32_t ticks)
+{
+	while (ticks > SLEEP_DELAY_MAX_TICKS) {
+		sleep_delay_period(SLEEP_DELAY_MAX_TICKS);
+		ticks -= SLEEP_DELAY_MAX_TICKS;
+	}
+	if (ticks) {
+		sleep_delay_period(ticks);
+	}
+}
+
+/**
+ * \brief Initialize the delay timer
+ *
+ * The timer is only clocked while a delay runs.
+ */
+void sleep_delay_init(void)
+{
+	tc_enable(&CONFIG_SLEEP_DELAY_TC);
+	tc_set_overflow_interrupt_callback(&CONFIG_SLEEP_DELAY_TC,
+			sleep_delay_overflow_handler);
+	tc_set_wgm(&CONFIG_SLEEP_DELAY_TC, TC_WG_NORMAL);
+	tc_disable(&CONFIG_SLEEP_DELAY_TC);
+}
+
+/**
+ * \brief Wait a number of microseconds
+ *
+ * \param us the delay
+ */
+void sleep_delay_us(uint16_t us)
+{
+	if (us < CONFIG_SLEEP_DELAY_MIN_US) {
+		delay_us(us);
+		return;
+	}
+	sleep_delay_ticks((uint32_t)us * (sysclk_get_per_hz() / 1000) / 1000);
+}
+
+/**
+ * \brief Wait a number of milliseconds
+ *
+ * \param ms the delay
+ */
+void sleep_delay_ms(uint16_t ms)
+{
+	sleep_delay_ticks((uint32_t)ms * (sysclk_get_per_hz() / 1000));
+}
@@ -0,0 +1,28 @@
+/**
+ * \file
+ *
+ * \brief Sleeping delays on a timer counter
+ *
+ * Times each delay on CONFIG_SLEEP_DELAY_TC and sleeps the CPU in idle
+ * mode until the timer overflows, so interrupts are still served while
+ * waiting. The timer period is derived from the peripheral clock at the
+ * start of each delay, so a delay is right for whatever clock runs then.
+ * Delays shorter than CONFIG_SLEEP_DELAY_MIN_US cost less than setting up
+ * the timer, so they are counted in CPU cycles by delay_us() instead.
+ *
+ * With interrupts disabled the timer is polled rather than slept on. The
+ * CPU sleeps through the sleep manager, or through
+ * CONFIG_SLEEP_DELAY_ENTER_SLEEP() if conf_sleep_delay.h defines it, and the
+ * timer is only enabled during a delay.
+ */
+#ifndef SLEEP_DELAY_H_INCLUDED
+#define SLEEP_DELAY_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_sleep_delay.h>
+
+void sleep_delay_init(void);
+void sleep_delay_us(uint16_t us);
+void sleep_delay_ms(uint16_t ms);
+
+#endif /* SLEEP_DELAY_H_INCLUDED */
@@ -0,0 +1,189 @@
+/**
+ * \file
+ *
+ * \brief Sleep mode residency and wakeup accounting
+ *
+ */
+#include <asf.h>
+#include <systime/systime.h>
+#include <console/console.h>
+#include "sleep_stats.h"
+
+#ifdef CONFIG_SLEEP_STATS
+
+//! \internal Names of the sleep modes, for the dump
+static const char *const sleep_stats_mode_names[SLEEPMGR_NR_OF_MODES] = {
+	"active", "idle", "estdby", "psave", "stdby", "pdown",
+};
+
+//! \internal Names of the wakeup sources, for the dump
+static const char *const sleep_stats_source_names[SLEEP_STATS_NR_OF_SOURCES] = {
+	"sched", "soft_timer", "systime", "adc", "button", "rtc", "other",
+};
+
+//! \internal Time spent in each mode
+static struct sleep_stats_time sleep_stats_residency[SLEEPMGR_NR_OF_MODES];
+//! \internal Wakeups by each source
+static uint32_t sleep_stats_wakeups[SLEEP_STATS_NR_OF_SOURCES];
+//! \internal Time accounted since the last reset, asleep or not
+static struct sleep_stats_time sleep_stats_total;
+//! \internal Clock time the accounting last reached
+static uint32_t sleep_stats_last;
+
+//! \internal Whether the CPU is asleep, until the first interrupt stamps it
+static volatile bool sleep_stats_sleeping;
+//! \internal Clock time and source of the last wakeup
+static uint32_t sleep_stats_woke_at;
+static enum sleep_stats_source sleep_stats_source;
+
+/**
+ * \internal
+ * \brief Add \a us microseconds to \a time
+ */
+static void sleep_stats_add(struct sleep_stats_time *time, uint32_t us)
+{
+	us += time->us;
+	time->ms += us / 1000;
+	time->us = us % 1000;
+}
+
+/**
+ * \brief Start accounting
+ *
+ * \note Runs on the monotonic clock, so systime_init() must be called first.
+ */
+void sleep_stats_init(void)
+{
+	sleep_stats_reset();
+#ifdef CONFIG_SLEEP_STATS_CONSOLE
+	console_init();
+	console_register_command('s', sleep_stats_dump);
+#endif
+}
+
+/**
+ * \brief Sleep in the deepest allowed mode and account for it
+ *
+ * Must be called with interrupts disabled, like sleepmgr_enter_sleep(), and
+ * returns with them enabled. The time awake since the previous call counts
+ * as active.
+ */
+void sleep_stats_enter_sleep(void)
+{
+	enum sleepmgr_mode mode = sleepmgr_get_sleep_mode();
+	uint32_t start = systime_now();
+
+	sleep_stats_add(&sleep_stats_residency[SLEEPMGR_ACTIVE],
+			start - sleep_stats_last);
+	sleep_stats_add(&sleep_stats_total, start - sleep_stats_last);
+	sleep_stats_last = start;
+	if (mode == SLEEPMGR_ACTIVE) {
+		cpu_irq_enable();
+		return;
+	}
+
+	sleep_stats_source = SLEEP_STATS_OTHER;
+	sleep_stats_sleeping = true;
+	sleepmgr_enter_sleep();
+
+	cpu_irq_disable();
+	if (sleep_stats_sleeping) {
+		sleep_stats_sleeping = false;
+		sleep_stats_woke_at = systime_now();
+	}
+	sleep_stats_add(&sleep_stats_residency[mode],
+			sleep_stats_woke_at - start);
+	sleep_stats_add(&sleep_stats_total, sleep_stats_woke_at - start);
+	sleep_stats_wakeups[sleep_stats_source]++;
+	sleep_stats_last = sleep_stats_woke_at;
+	cpu_irq_enable();
+}
+
+/**
+ * \brief Record the wakeup source, from an interrupt handler
+ *
+ * Does nothing unless the CPU slept until this interrupt.
+ *
+ * \param source the source of the interrupt
+ */
+void sleep_stats_wakeup(enum sleep_stats_source source)
+{
+	if (!sleep_stats_sleeping) {
+		return;
+	}
+	sleep_stats_sleeping = false;
+	sleep_stats_woke_at = systime_now();
+	sleep_stats_source = source;
+}
+
+/**
+ * \brief Get the time spent in a mode since the last reset
+ *
+ * \param mode the mode, SLEEPMGR_ACTIVE for the time awake
+ * \param time where to store the time
+ */
+void sleep_stats_get_residency(enum sleepmgr_mode mode,
+		struct sleep_stats_time *time)
+{
+	irqflags_t flags;
+
+	Assert(mode < SLEEPMGR_NR_OF_MODES);
+
+	flags = cpu_irq_save();
+	*time = sleep_stats_residency[mode];
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Get the number of wakeups by a source since the last reset
+ */
+uint32_t sleep_stats_get_wakeups(enum sleep_stats_source source)
+{
+	Assert(source < SLEEP_STATS_NR_OF_SOURCES);
+
+	return sleep_stats_wakeups[source];
+}
+
+/**
+ * \brief Clear the statistics
+ */
+void sleep_stats_reset(void)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	memset(sleep_stats_residency, 0, sizeof(sleep_stats_residency));
+	memset(sleep_stats_wakeups, 0, sizeof(sleep_stats_wakeups));
+	memset(&sleep_stats_total, 0, sizeof(sleep_stats_total));
+	sleep_stats_last = systime_now();
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Print the statistics on the console
+ *
+ * "S total ms", then "S mode name ms" for each mode the CPU was in and
+ * "S wake name n" for each source that woke it, then "S end". Times are
+ * accounted up to the last wakeup.
+ */
+void sleep_stats_dump(void)
+{
+	console_printf("S total %lu\r\n", sleep_stats_total.ms);
+	for (uint8_t i = 0; i < SLEEPMGR_NR_OF_MODES; i++) {
+		if (sleep_stats_residency[i].ms || sleep_stats_residency[i].us) {
+			console_printf("S mode %s %lu\r\n",
+					sleep_stats_mode_names[i],
+					sleep_stats_residency[i].ms);
+		}
+	}
+	for (uint8_t i = 0; i < SLEEP_STATS_NR_OF_SOURCES; i++) {
+		if (sleep_stats_wakeups[i]) {
+			console_printf("S wake %s %lu\r\n",
+					sleep_stats_source_names[i],
+					sleep_stats_wakeups[i]);
+		}
+	}
+	console_puts("S end\r\n");
+}
+
+#endif /* CONFIG_SLEEP_STATS */
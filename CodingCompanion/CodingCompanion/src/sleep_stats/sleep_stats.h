@@ -0,0 +1,96 @@
+/**
+ * \file
+ *
+ * \brief Sleep mode residency and wakeup accounting
+ *
+ * sleep_stats_enter_sleep() replaces sleepmgr_enter_sleep() in idle loops.
+ * It sleeps in the deepest mode the sleep manager locks allow, and adds the
+ * time asleep to that mode on the monotonic clock. Interrupt handlers that
+ * can end a sleep call sleep_stats_wakeup() first thing, which stamps the
+ * end of the sleep and counts the wakeup against their source; a sleep ended
+ * by any other interrupt counts as SLEEP_STATS_OTHER.
+ *
+ * Without CONFIG_SLEEP_STATS the hooks compile to nothing and
+ * sleep_stats_enter_sleep() is sleepmgr_enter_sleep().
+ */
+#ifndef SLEEP_STATS_H_INCLUDED
+#define SLEEP_STATS_H_INCLUDED
+
+#include <compiler.h>
+#include <sleepmgr.h>
+#include <conf_sleep_stats.h>
+
+//! Wakeup sources
+enum sleep_stats_source {
+	//! Scheduler alarm
+	SLEEP_STATS_SCHED,
+	//! Software timer alarm
+	SLEEP_STATS_SOFT_TIMER,
+	//! Either alarm on the high counter of the clock
+	SLEEP_STATS_SYSTIME,
+	//! ADC conversion complete
+	SLEEP_STATS_ADC,
+	//! Button pin change
+	SLEEP_STATS_BUTTON,
+	//! RTC second tick
+	SLEEP_STATS_RTC,
+	//! Any other interrupt
+	SLEEP_STATS_OTHER,
+	SLEEP_STATS_NR_OF_SOURCES,
+};
+
+//! Time accumulated in one mode, split to count beyond the clock wrap
+struct sleep_stats_time {
+	uint32_t ms;
+	uint16_t us;
+};
+
+#ifdef CONFIG_SLEEP_STATS
+
+void sleep_stats_init(void);
+void sleep_stats_enter_sleep(void);
+void sleep_stats_wakeup(enum sleep_stats_source source);
+void sleep_stats_get_residency(enum sleepmgr_mode mode,
+		struct sleep_stats_time *time);
+uint32_t sleep_stats_get_wakeups(enum sleep_stats_source source);
+void sleep_stats_reset(void);
+void sleep_stats_dump(void);
+
+#else
+
+static inline void sleep_stats_init(void)
+{
+}
+
+static inline void sleep_stats_enter_sleep(void)
+{
+	sleepmgr_enter_sleep();
+}
+
+static inline void sleep_stats_wakeup(enum sleep_stats_source source)
+{
+}
+
+static inline void sleep_stats_get_residency(enum sleepmgr_mode mode,
+		struct sleep_stats_time *time)
+{
+	time->ms = 0;
+	time->us = 0;
+}
+
+static inline uint32_t sleep_stats_get_wakeups(enum sleep_stats_source source)
+{
+	return 0;
+}
+
+static inline void sleep_stats_reset(void)
+{
+}
+
+static inline void sleep_stats_dump(void)
+{
+}
+
+#endif
+
+#endif /* SLEEP_STATS_H_INCLUDED */
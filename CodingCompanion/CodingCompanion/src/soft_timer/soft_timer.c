@@ -0,0 +1,281 @@
+/**
+ * \file
+ *
+ * \brief Software timers on a hierarchical timer wheel
+ *
+ */
+#include <asf.h>
+#include "soft_timer.h"
+
+//! \internal Slot of \a tick on wheel \a level
+#define SOFT_TIMER_SLOT(tick, level) \
+	(((tick) >> ((level) * SOFT_TIMER_SLOT_BITS)) & (SOFT_TIMER_SLOTS - 1))
+
+//! \internal Timer lists, one per slot and level
+static struct soft_timer *soft_timer_wheel[SOFT_TIMER_LEVELS][SOFT_TIMER_SLOTS];
+//! \internal Next tick to process
+static uint32_t soft_timer_current;
+//! \internal Number of running timers
+static uint16_t soft_timer_count;
+
+/**
+ * \internal
+ * \brief Link a timer into the slot for its expiry
+ *
+ * The level is picked from the distance to the expiry, so the slot is
+ * cascaded to the level below no later than the timer expires. A timer that
+ * is already late goes into the current slot.
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void soft_timer_add(struct soft_timer *timer)
+{
+	uint32_t delta = timer->expires - soft_timer_current;
+	struct soft_timer **slot;
+	uint8_t level;
+
+	if ((int32_t)delta < 0) {
+		timer->expires = soft_timer_current;
+		delta = 0;
+	}
+	for (level = 0; level < SOFT_TIMER_LEVELS - 1; level++) {
+		if (delta < (1UL << ((level + 1) * SOFT_TIMER_SLOT_BITS))) {
+			break;
+		}
+	}
+
+	slot = &soft_timer_wheel[level][SOFT_TIMER_SLOT(timer->expires, level)];
+	timer->next = *slot;
+	if (*slot) {
+		(*slot)->pprev = &timer->next;
+	}
+	*slot = timer;
+	timer->pprev = slot;
+}
+
+/**
+ * \internal
+ * \brief Unlink a timer from its slot
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void soft_timer_unlink(struct soft_timer *timer)
+{
+	*timer->pprev = timer->next;
+	if (timer->next) {
+		timer->next->pprev = timer->pprev;
+	}
+	timer->pprev = NULL;
+}
+
+/**
+ * \internal
+ * \brief Move the timers of one slot to the level below
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void soft_timer_cascade(uint8_t level, uint8_t index)
+{
+	struct soft_timer *timer = soft_timer_wheel[level][index];
+	struct soft_timer *next;
+
+	soft_timer_wheel[level][index] = NULL;
+	for (; timer; timer = next) {
+		next = timer->next;
+		soft_timer_add(timer);
+	}
+}
+
+/**
+ * \internal
+ * \brief Expire every timer up to and including tick \a now
+ *
+ * Callbacks run with interrupts enabled, and a timer may start or cancel any
+ * timer from its callback.
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void soft_timer_process(uint32_t now)
+{
+	struct soft_timer *timer;
+	uint8_t index;
+
+	while ((int32_t)(now - soft_timer_current) >= 0) {
+		index = SOFT_TIMER_SLOT(soft_timer_current, 0);
+		if (!index) {
+			/* The lowest level wrapped, pull the next slot of each
+			 * level down, as far up as levels wrap together. */
+			for (uint8_t level = 1; level < SOFT_TIMER_LEVELS; level++) {
+				uint8_t slot = SOFT_TIMER_SLOT(soft_timer_current, level);
+
+				soft_timer_cascade(level, slot);
+				if (slot) {
+					break;
+				}
+			}
+		}
+
+		while ((timer = soft_timer_wheel[0][index])) {
+			soft_timer_unlink(timer);
+			if (timer->period) {
+				/* Skip periods that were missed rather than
+				 * firing back to back */
+				timer->expires += timer->period;
+				if ((int32_t)(timer->expires - now) <= 0) {
+					timer->expires = now + timer->period;
+				}
+				soft_timer_add(timer);
+			} else {
+				soft_timer_count--;
+			}
+			cpu_irq_enable();
+			timer->callback();
+			cpu_irq_disable();
+		}
+
+		soft_timer_current++;
+	}
+}
+
+/**
+ * \internal
+ * \brief Set the alarm for the next tick that needs processing
+ *
+ * That is the next occupied slot of the lowest level, or its next wrap if
+ * that comes first.
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void soft_timer_arm(void)
+{
+	uint8_t index = SOFT_TIMER_SLOT(soft_timer_current, 0);
+	uint8_t slot;
+
+	if (!soft_timer_count) {
+		systime_alarm_cancel(SYSTIME_ALARM_SOFT_TIMER);
+		return;
+	}
+
+	/* A wrap of the lowest level is always stopped at, the timers cascaded
+	 * there may expire before any that are already on the lowest level. */
+	slot = index;
+	if (index) {
+		while (slot < SOFT_TIMER_SLOTS && !soft_timer_wheel[0][slot]) {
+			slot++;
+		}
+	}
+	systime_alarm_set(SYSTIME_ALARM_SOFT_TIMER,
+			(soft_timer_current + (slot - index))
+			<< CONFIG_SOFT_TIMER_TICK_SHIFT);
+}
+
+/**
+ * \internal
+ * \brief Callback for the timer alarm
+ */
+static void soft_timer_alarm_handler(void)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	soft_timer_process(soft_timer_now());
+	soft_timer_arm();
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Initialize the timer wheel
+ *
+ * \note Runs on the monotonic clock, so systime_init() must be called first.
+ */
+void soft_timer_init(void)
+{
+	memset(soft_timer_wheel, 0, sizeof(soft_timer_wheel));
+	soft_timer_count = 0;
+	soft_timer_current = systime_now() >> CONFIG_SOFT_TIMER_TICK_SHIFT;
+
+	systime_alarm_init(SYSTIME_ALARM_SOFT_TIMER, soft_timer_alarm_handler);
+}
+
+/**
+ * \brief Read the current time
+ *
+ * Counted on from the tick before the next one to process, which has always
+ * started, so the timer ticks keep the full 32-bit range although they are
+ * derived from the clock.
+ *
+ * \retval the current time in timer ticks
+ */
+uint32_t soft_timer_now(void)
+{
+	irqflags_t flags;
+	uint32_t base;
+	uint32_t elapsed;
+
+	flags = cpu_irq_save();
+	base = soft_timer_current - 1;
+	elapsed = systime_now() - (base << CONFIG_SOFT_TIMER_TICK_SHIFT);
+	base += elapsed >> CONFIG_SOFT_TIMER_TICK_SHIFT;
+	cpu_irq_restore(flags);
+
+	return base;
+}
+
+/**
+ * \brief Start a timer
+ *
+ * A timer that is already running is restarted. Safe to call from
+ * interrupts and from timer callbacks.
+ *
+ * \param timer the timer, with \a callback set
+ * \param delay ticks until the first expiry, at most SOFT_TIMER_MAX_TICKS
+ * \param period ticks between expiries, 0 to expire only once
+ */
+void soft_timer_start(struct soft_timer *timer, uint32_t delay,
+		uint32_t period)
+{
+	irqflags_t flags;
+
+	Assert(timer->callback);
+	Assert(delay <= SOFT_TIMER_MAX_TICKS);
+	Assert(period <= SOFT_TIMER_MAX_TICKS);
+
+	flags = cpu_irq_save();
+	if (timer->pprev) {
+		soft_timer_unlink(timer);
+		soft_timer_count--;
+	}
+	if (!soft_timer_count) {
+		/* Nothing ran while the wheel was idle, catch up in one step */
+		soft_timer_current = soft_timer_now();
+	}
+	timer->expires = soft_timer_now() + delay;
+	timer->period = period;
+	soft_timer_add(timer);
+	soft_timer_count++;
+	soft_timer_arm();
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Stop a timer
+ *
+ * Does nothing if the timer is not running. Safe to call from interrupts
+ * and from timer callbacks.
+ *
+ * \param timer the timer
+ */
+void soft_timer_cancel(struct soft_timer *timer)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	if (timer->pprev) {
+		soft_timer_unlink(timer);
+		soft_timer_count--;
+		if (!soft_timer_count) {
+			systime_alarm_cancel(SYSTIME_ALARM_SOFT_TIMER);
+		}
+	}
+	cpu_irq_restore(flags);
+}
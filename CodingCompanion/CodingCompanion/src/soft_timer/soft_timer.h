@@ -0,0 +1,81 @@
+/**
+ * \file
+ *
+ * \brief Software timers on a hierarchical timer wheel
+ *
+ * Any number of one-shot and periodic timers share one alarm of the monotonic
+ * clock. Timers are kept in a four level wheel of 64 slots
+ * each, so starting and cancelling a timer takes constant time no matter how
+ * many are running. Timers further out than one level are moved down a level
+ * each time the level below wraps.
+ *
+ * The alarm is only set for the next occupied slot of the lowest level, or the
+ * next wrap of it, so an idle wheel causes no interrupts.
+ *
+ * Callbacks run from the alarm interrupt at the low level and must be kept
+ * short; longer work is handed to the main context with sched_start().
+ */
+#ifndef SOFT_TIMER_H_INCLUDED
+#define SOFT_TIMER_H_INCLUDED
+
+#include <compiler.h>
+#include <systime/systime.h>
+#include <conf_soft_timer.h>
+
+//! Number of wheel levels
+#define SOFT_TIMER_LEVELS     4
+//! log2 of the number of slots per level
+#define SOFT_TIMER_SLOT_BITS  6
+//! Number of slots per level
+#define SOFT_TIMER_SLOTS      (1 << SOFT_TIMER_SLOT_BITS)
+//! Longest delay or period, in timer ticks
+#define SOFT_TIMER_MAX_TICKS \
+	((1UL << (SOFT_TIMER_LEVELS * SOFT_TIMER_SLOT_BITS)) - 1)
+
+//! Timer ticks per second
+#define SOFT_TIMER_TICKS_PER_SEC \
+	(SYSTIME_TICKS_PER_SEC >> CONFIG_SOFT_TIMER_TICK_SHIFT)
+
+//! Convert milliseconds to timer ticks, rounded to the nearest tick
+#define SOFT_TIMER_MS(ms) \
+	((SYSTIME_MS(ms) + (1 << (CONFIG_SOFT_TIMER_TICK_SHIFT - 1))) \
+	>> CONFIG_SOFT_TIMER_TICK_SHIFT)
+
+//! Timer callback, runs in interrupt context
+typedef void (*soft_timer_callback_t)(void);
+
+/**
+ * \brief Timer descriptor
+ *
+ * Owned by the caller. Only \a callback is set by the caller, the rest is
+ * private to the wheel.
+ */
+struct soft_timer {
+	soft_timer_callback_t callback;
+	//! Next timer in the same slot
+	struct soft_timer *next;
+	//! Link pointing at this timer, NULL while the timer is stopped
+	struct soft_timer **pprev;
+	//! Timer tick at which the timer expires
+	uint32_t expires;
+	//! Ticks between expiries, 0 for a one-shot timer
+	uint32_t period;
+};
+
+void soft_timer_init(void);
+uint32_t soft_timer_now(void);
+void soft_timer_start(struct soft_timer *timer, uint32_t delay,
+		uint32_t period);
+void soft_timer_cancel(struct soft_timer *timer);
+
+/**
+ * \brief Check whether a timer is running
+ *
+ * \retval true if the timer is started and has not expired, or is periodic
+ */
+static inline bool soft_timer_is_active(const struct soft_timer *timer)
+{
+	return timer->pprev != NULL;
+}
+
+#endif /* SOFT_TIMER_H_INCLUDED */
@@ -0,0 +1,252 @@
+/**
+ * \file
+ *
+ * \brief Tones and melodies on the buzzer
+ *
+ */
+#include <asf.h>
+#include <soft_timer/soft_timer.h>
+#include <clock_scale/clock_scale.h>
+#include "sound.h"
+
+PROGMEM_DECLARE(struct sound_note, sound_alert_minor[]) = {
+	{2000, 80},
+	{0, 80},
+	{2000, 80},
+	{0, 0},
+};
+
+PROGMEM_DECLARE(struct sound_note, sound_alert_major[]) = {
+	{1500, 120},
+	{0, 40},
+	{2000, 120},
+	{0, 40},
+	{2500, 120},
+	{0, 600},
+	{0, 0},
+};
+
+//! \internal Prescalers of the timer counter, from the smallest
+static const struct {
+	uint16_t div;
+	TC_CLKSEL_t clksel;
+} sound_prescalers[] = {
+	{1, TC_CLKSEL_DIV1_gc},
+	{2, TC_CLKSEL_DIV2_gc},
+	{4, TC_CLKSEL_DIV4_gc},
+	{8, TC_CLKSEL_DIV8_gc},
+	{64, TC_CLKSEL_DIV64_gc},
+	{256, TC_CLKSEL_DIV256_gc},
+	{1024, TC_CLKSEL_DIV1024_gc},
+};
+#define SOUND_NR_OF_PRESCALERS \
+	(sizeof(sound_prescalers) / sizeof(sound_prescalers[0]))
+
+//! \internal Melody being played, NULL for a single tone
+static const struct sound_note *sound_melody;
+//! \internal Next note to play
+static const struct sound_note *sound_next;
+//! \internal Whether the melody starts over when it ends
+static bool sound_loop;
+//! \internal Whether a tone or melody is playing
+static volatile bool sound_playing;
+//! \internal Frequency on the buzzer pin, 0 if silent
+static uint16_t sound_freq_hz;
+
+static struct soft_timer sound_timer;
+static struct clock_scale_notifier sound_clock_notifier;
+
+/**
+ * \internal
+ * \brief Output a tone on the buzzer pin, or silence it
+ *
+ * The counter toggles the pin each time it reaches CCA, so CCA is set to
+ * half a tone period, with the smallest prescaler that fits it.
+ *
+ * \param freq_hz the tone frequency, 0 to silence the buzzer
+ */
+static void sound_output(uint16_t freq_hz)
+{
+	uint32_t half_period;
+	uint8_t i = 0;
+
+	if (!freq_hz) {
+		if (sound_freq_hz) {
+			/* The pin goes back to its port level, which is low,
+			 * and the timer is only clocked while a tone plays */
+			tc_write_clock_source(&CONFIG_SOUND_TC, TC_CLKSEL_OFF_gc);
+			tc_disable_cc_channels(&CONFIG_SOUND_TC, TC_CCAEN);
+			tc_disable(&CONFIG_SOUND_TC);
+			sound_freq_hz = 0;
+		}
+		return;
+	}
+	if (!sound_freq_hz) {
+		tc_enable(&CONFIG_SOUND_TC);
+	}
+	sound_freq_hz = freq_hz;
+	tc_write_clock_source(&CONFIG_SOUND_TC, TC_CLKSEL_OFF_gc);
+
+	half_period = clock_scale_get_hz() / (2UL * freq_hz);
+	while (i < SOUND_NR_OF_PRESCALERS - 1
+			&& half_period / sound_prescalers[i].div > 0x10000) {
+		i++;
+	}
+	half_period /= sound_prescalers[i].div;
+
+	tc_write_cc(&CONFIG_SOUND_TC, TC_CCA, half_period ? half_period - 1 : 0);
+	tc_write_count(&CONFIG_SOUND_TC, 0);
+	tc_enable_cc_channels(&CONFIG_SOUND_TC, TC_CCAEN);
+	tc_write_clock_source(&CONFIG_SOUND_TC, sound_prescalers[i].clksel);
+}
+
+/**
+ * \internal
+ * \brief Start the next note of the melody
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void sound_step(void)
+{
+	uint16_t freq_hz;
+	uint16_t duration_ms;
+
+	duration_ms = PROGMEM_READ_WORD(&sound_next->duration_ms);
+	if (!duration_ms && sound_loop && sound_next != sound_melody) {
+		sound_next = sound_melody;
+		duration_ms = PROGMEM_READ_WORD(&sound_next->duration_ms);
+	}
+	if (!duration_ms) {
+		sound_output(0);
+		sound_playing = false;
+		return;
+	}
+	freq_hz = PROGMEM_READ_WORD(&sound_next->freq_hz);
+	sound_next++;
+
+	sound_output(freq_hz);
+	soft_timer_start(&sound_timer, SOFT_TIMER_MS(duration_ms), 0);
+}
+
+/**
+ * \internal
+ * \brief Callback for the end of a note or tone
+ */
+static void sound_timer_handler(void)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	if (sound_melody) {
+		sound_step();
+	} else {
+		sound_output(0);
+		sound_playing = false;
+	}
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \internal
+ * \brief Callback for clock switches
+ *
+ * Derives the compare value and prescaler of the sounding tone again.
+ */
+static void sound_clock_handler(enum clock_scale_event event)
+{
+	if ((event == CLOCK_SCALE_POST_CHANGE) && sound_freq_hz) {
+		sound_output(sound_freq_hz);
+	}
+}
+
+/**
+ * \brief Initialize the buzzer pin and the tone timer
+ *
+ * \note Notes are timed by the software timers, so soft_timer_init() must be
+ * called first.
+ */
+void sound_init(void)
+{
+	ioport_set_pin_level(CONFIG_SOUND_PIN, IOPORT_PIN_LEVEL_LOW);
+	ioport_set_pin_dir(CONFIG_SOUND_PIN, IOPORT_DIR_OUTPUT);
+
+	/* The waveform mode is kept while the clock of the timer is stopped */
+	tc_enable(&CONFIG_SOUND_TC);
+	tc_set_wgm(&CONFIG_SOUND_TC, TC_WG_FRQ);
+	tc_disable(&CONFIG_SOUND_TC);
+
+	sound_melody = NULL;
+	sound_playing = false;
+	sound_freq_hz = 0;
+	sound_timer.callback = sound_timer_handler;
+	sound_clock_notifier.fn = sound_clock_handler;
+	clock_scale_register(&sound_clock_notifier);
+}
+
+/**
+ * \brief Play a single tone
+ *
+ * Replaces whatever is playing.
+ *
+ * \param freq_hz the tone frequency
+ * \param duration_ms how long to play it, 0 to play until sound_stop()
+ */
+void sound_tone(uint16_t freq_hz, uint16_t duration_ms)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	soft_timer_cancel(&sound_timer);
+	sound_melody = NULL;
+	sound_output(freq_hz);
+	sound_playing = freq_hz != 0;
+	if (sound_playing && duration_ms) {
+		soft_timer_start(&sound_timer, SOFT_TIMER_MS(duration_ms), 0);
+	}
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Play a melody
+ *
+ * Replaces whatever is playing.
+ *
+ * \param melody the notes, in flash
+ * \param loop whether to start over at the end until sound_stop()
+ */
+void sound_play(const struct sound_note *melody, bool loop)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	soft_timer_cancel(&sound_timer);
+	sound_melody = melody;
+	sound_next = melody;
+	sound_loop = loop;
+	sound_playing = true;
+	sound_step();
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Stop the tone or melody that is playing
+ */
+void sound_stop(void)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	soft_timer_cancel(&sound_timer);
+	sound_melody = NULL;
+	sound_output(0);
+	sound_playing = false;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Check whether a tone or melody is playing
+ */
+bool sound_is_playing(void)
+{
+	return sound_playing;
+}
@@ -0,0 +1,40 @@
+/**
+ * \file
+ *
+ * \brief Tones and melodies on the buzzer
+ *
+ * The timer counter of conf_sound.h runs in frequency generation mode and
+ * toggles the buzzer pin on its own, so a tone costs no CPU time while it
+ * sounds. Melodies are note sequences in flash, stepped by a software timer
+ * that only wakes the CPU once per note.
+ */
+#ifndef SOUND_H_INCLUDED
+#define SOUND_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_sound.h>
+
+/**
+ * \brief One note of a melody
+ *
+ * A melody is an array of notes in flash, ended by a note of zero duration.
+ */
+struct sound_note {
+	//! Tone frequency in Hz, 0 for a rest
+	uint16_t freq_hz;
+	//! Length of the note in milliseconds
+	uint16_t duration_ms;
+};
+
+//! Short double beep for a minor alert
+extern PROGMEM_DECLARE(struct sound_note, sound_alert_minor[]);
+//! Urgent rising triple beep for a major alert
+extern PROGMEM_DECLARE(struct sound_note, sound_alert_major[]);
+
+void sound_init(void);
+void sound_tone(uint16_t freq_hz, uint16_t duration_ms);
+void sound_play(const struct sound_note *melody, bool loop);
+void sound_stop(void);
+bool sound_is_playing(void);
+
+#endif /* SOUND_H_INCLUDED */
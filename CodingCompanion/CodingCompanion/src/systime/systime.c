@@ -0,0 +1,313 @@
+/**
+ * \file
+ *
+ * \brief 32-bit monotonic microsecond clock
+ *
+ */
+#include <asf.h>
+#include <isr_prof/isr_prof.h>
+#include <clock_scale/clock_scale.h>
+#include <sleep_stats/sleep_stats.h>
+#include "systime.h"
+
+//! \internal Event multiplexer of the channel linking the counters
+#define SYSTIME_EVSYS_CHMUX \
+	(*(&EVSYS.CH0MUX + CONFIG_SYSTIME_EVSYS_CH))
+//! \internal Clock source of the high counter
+#define SYSTIME_EVSYS_CLKSEL \
+	((TC_CLKSEL_t)(TC_CLKSEL_EVCH0_gc + CONFIG_SYSTIME_EVSYS_CH))
+//! \internal Event multiplexer of the channel clocking the low counter
+#define SYSTIME_EVSYS_CLK_CHMUX \
+	(*(&EVSYS.CH0MUX + CONFIG_SYSTIME_EVSYS_CLK_CH))
+//! \internal Clock source of the low counter
+#define SYSTIME_EVSYS_CLK_CLKSEL \
+	((TC_CLKSEL_t)(TC_CLKSEL_EVCH0_gc + CONFIG_SYSTIME_EVSYS_CLK_CH))
+
+/**
+ * \internal
+ * \brief Shortest distance at which an alarm compare is known to be ahead
+ *
+ * Covers the time from reading the clock to writing the compare register.
+ * Alarms closer than this are fired this far out instead, and checked again.
+ */
+#define SYSTIME_ALARM_MARGIN 32
+
+//! \internal Time of each alarm
+static uint32_t systime_alarm_at[SYSTIME_NR_OF_ALARMS];
+//! \internal Callback of each alarm
+static systime_alarm_callback_t systime_alarm_callback[SYSTIME_NR_OF_ALARMS];
+
+static struct clock_scale_notifier systime_clock_notifier;
+
+/**
+ * \internal
+ * \brief Event system prescaler that makes the low counter count microseconds
+ *
+ * The event system divides clkPER by any power of two, which covers every
+ * clock from 1 to 32 MHz that is a power of two in MHz; the timer counter
+ * prescaler stops at 8 between 1 and 64.
+ */
+static uint8_t systime_get_prescaler(void)
+{
+	uint32_t hz = SYSTIME_TICKS_PER_SEC;
+	uint8_t chmux = EVSYS_CHMUX_PRESCALER_1_gc;
+
+	while (hz < sysclk_get_per_hz()) {
+		hz <<= 1;
+		chmux++;
+	}
+	Assert(hz == sysclk_get_per_hz());
+
+	return chmux;
+}
+
+/**
+ * \internal
+ * \brief Callback for clock switches
+ *
+ * Moves the low counter to the prescaler of the new clock in the same
+ * critical section as the switch, so the clock loses less than a tick.
+ */
+static void systime_clock_handler(enum clock_scale_event event)
+{
+	if (event == CLOCK_SCALE_POST_CHANGE) {
+		SYSTIME_EVSYS_CLK_CHMUX = systime_get_prescaler();
+	}
+}
+
+/**
+ * \internal
+ * \brief Set the interrupt level of the compare channel of an alarm
+ */
+static void systime_alarm_set_level(volatile void *tc,
+		enum systime_alarm alarm, enum TC_INT_LEVEL_t level)
+{
+	if (alarm == SYSTIME_ALARM_SCHED) {
+		tc_set_cca_interrupt_level(tc, level);
+	} else {
+		tc_set_ccb_interrupt_level(tc, level);
+	}
+}
+
+/**
+ * \internal
+ * \brief Program the compare channels for an alarm
+ *
+ * A compare on the low counter is used if the alarm falls in its current
+ * period, otherwise a compare on the high counter waits for that period to
+ * begin. If the high counter gets there while it is being programmed, the
+ * low counter is programmed instead.
+ *
+ * \note Must be called with interrupts disabled.
+ */
+static void systime_alarm_update(enum systime_alarm alarm)
+{
+	enum tc_cc_channel_t cc = (enum tc_cc_channel_t)(TC_CCA + alarm);
+	uint32_t at = systime_alarm_at[alarm];
+	uint32_t now;
+
+	systime_alarm_set_level(&CONFIG_SYSTIME_TC_HIGH, alarm, TC_INT_LVL_OFF);
+	systime_alarm_set_level(&CONFIG_SYSTIME_TC_LOW, alarm, TC_INT_LVL_OFF);
+
+	while (1) {
+		now = systime_now();
+		if ((int32_t)(at - now) < SYSTIME_ALARM_MARGIN) {
+			tc_write_cc(&CONFIG_SYSTIME_TC_LOW, cc,
+					tc_read_count(&CONFIG_SYSTIME_TC_LOW)
+					+ SYSTIME_ALARM_MARGIN);
+			break;
+		}
+		if ((uint16_t)(at >> 16) == (uint16_t)(now >> 16)) {
+			tc_write_cc(&CONFIG_SYSTIME_TC_LOW, cc, (uint16_t)at);
+			break;
+		}
+
+		tc_write_cc(&CONFIG_SYSTIME_TC_HIGH, cc, (uint16_t)(at >> 16));
+		tc_clear_cc_interrupt(&CONFIG_SYSTIME_TC_HIGH, cc);
+		if (tc_read_count(&CONFIG_SYSTIME_TC_HIGH) != (uint16_t)(at >> 16)) {
+			systime_alarm_set_level(&CONFIG_SYSTIME_TC_HIGH, alarm,
+					TC_INT_LVL_LO);
+			return;
+		}
+	}
+
+	tc_clear_cc_interrupt(&CONFIG_SYSTIME_TC_LOW, cc);
+	systime_alarm_set_level(&CONFIG_SYSTIME_TC_LOW, alarm, TC_INT_LVL_LO);
+}
+
+/**
+ * \internal
+ * \brief Handle a compare on the low counter
+ *
+ * Fires the alarm if its time has come; a compare set short of it only
+ * re-programs the channels.
+ */
+static void systime_alarm_low_handler(enum systime_alarm alarm)
+{
+	irqflags_t flags;
+
+	sleep_stats_wakeup((enum sleep_stats_source)(SLEEP_STATS_SCHED + alarm));
+	isr_prof_tc_compare((enum isr_prof_vector)(ISR_PROF_SCHED_ALARM + alarm),
+			&CONFIG_SYSTIME_TC_LOW, (enum tc_cc_channel_t)(TC_CCA + alarm));
+
+	flags = cpu_irq_save();
+	if (!systime_is_reached(systime_alarm_at[alarm], systime_now())) {
+		systime_alarm_update(alarm);
+		cpu_irq_restore(flags);
+		return;
+	}
+	systime_alarm_set_level(&CONFIG_SYSTIME_TC_LOW, alarm, TC_INT_LVL_OFF);
+	cpu_irq_restore(flags);
+
+	systime_alarm_callback[alarm]();
+}
+
+/**
+ * \internal
+ * \brief Callbacks for the compares of the two counters
+ *
+ * A compare on the high counter means the low counter has entered the period
+ * of the alarm, so the alarm is set again to move it to the low counter.
+ *
+ * @{
+ */
+static void systime_sched_low_handler(void)
+{
+	systime_alarm_low_handler(SYSTIME_ALARM_SCHED);
+}
+
+static void systime_sched_high_handler(void)
+{
+	sleep_stats_wakeup(SLEEP_STATS_SYSTIME);
+	isr_prof_tc_overflow(ISR_PROF_SYSTIME_HIGH, &CONFIG_SYSTIME_TC_LOW);
+	systime_alarm_set(SYSTIME_ALARM_SCHED,
+			systime_alarm_at[SYSTIME_ALARM_SCHED]);
+}
+
+static void systime_soft_timer_low_handler(void)
+{
+	systime_alarm_low_handler(SYSTIME_ALARM_SOFT_TIMER);
+}
+
+static void systime_soft_timer_high_handler(void)
+{
+	sleep_stats_wakeup(SLEEP_STATS_SYSTIME);
+	isr_prof_tc_overflow(ISR_PROF_SYSTIME_HIGH, &CONFIG_SYSTIME_TC_LOW);
+	systime_alarm_set(SYSTIME_ALARM_SOFT_TIMER,
+			systime_alarm_at[SYSTIME_ALARM_SOFT_TIMER]);
+}
+//! @}
+
+/**
+ * \brief Start the clock
+ *
+ * Both counters keep the sleep manager out of modes deeper than IDLE, so the
+ * clock keeps running while the CPU sleeps. The low counter is clocked from
+ * an event system prescaler, which follows the clock switches of
+ * clock_scale.h.
+ */
+void systime_init(void)
+{
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_EVSYS);
+	SYSTIME_EVSYS_CHMUX = CONFIG_SYSTIME_EVSYS_OVF;
+	SYSTIME_EVSYS_CLK_CHMUX = systime_get_prescaler();
+	systime_clock_notifier.fn = systime_clock_handler;
+	clock_scale_register(&systime_clock_notifier);
+
+	tc_enable(&CONFIG_SYSTIME_TC_HIGH);
+	tc_set_wgm(&CONFIG_SYSTIME_TC_HIGH, TC_WG_NORMAL);
+	tc_write_period(&CONFIG_SYSTIME_TC_HIGH, 0xffff);
+	tc_enable_cc_channels(&CONFIG_SYSTIME_TC_HIGH, TC_CCAEN | TC_CCBEN);
+	tc_set_cca_interrupt_callback(&CONFIG_SYSTIME_TC_HIGH,
+			systime_sched_high_handler);
+	tc_set_ccb_interrupt_callback(&CONFIG_SYSTIME_TC_HIGH,
+			systime_soft_timer_high_handler);
+	tc_write_clock_source(&CONFIG_SYSTIME_TC_HIGH, SYSTIME_EVSYS_CLKSEL);
+
+	tc_enable(&CONFIG_SYSTIME_TC_LOW);
+	tc_set_wgm(&CONFIG_SYSTIME_TC_LOW, TC_WG_NORMAL);
+	tc_write_period(&CONFIG_SYSTIME_TC_LOW, 0xffff);
+	tc_enable_cc_channels(&CONFIG_SYSTIME_TC_LOW, TC_CCAEN | TC_CCBEN);
+	tc_set_cca_interrupt_callback(&CONFIG_SYSTIME_TC_LOW,
+			systime_sched_low_handler);
+	tc_set_ccb_interrupt_callback(&CONFIG_SYSTIME_TC_LOW,
+			systime_soft_timer_low_handler);
+	tc_write_clock_source(&CONFIG_SYSTIME_TC_LOW, SYSTIME_EVSYS_CLK_CLKSEL);
+}
+
+/**
+ * \brief Read the clock
+ *
+ * The high half is read on both sides of the low half and the read is
+ * retried if it changed. A read in the first two counts after the low
+ * counter wrapped is retried too, as the overflow event may not have
+ * reached the high counter yet.
+ *
+ * \retval microseconds since systime_init(), wrapping after 2^32
+ */
+uint32_t systime_now(void)
+{
+	irqflags_t flags;
+	uint16_t high;
+	uint16_t low;
+	bool torn;
+
+	do {
+		flags = cpu_irq_save();
+		high = tc_read_count(&CONFIG_SYSTIME_TC_HIGH);
+		low = tc_read_count(&CONFIG_SYSTIME_TC_LOW);
+		torn = (high != tc_read_count(&CONFIG_SYSTIME_TC_HIGH)) || (low < 2);
+		cpu_irq_restore(flags);
+	} while (torn);
+
+	return ((uint32_t)high << 16) | low;
+}
+
+/**
+ * \brief Set the callback of an alarm
+ *
+ * \param alarm the alarm
+ * \param callback called from the compare interrupt when the alarm fires
+ */
+void systime_alarm_init(enum systime_alarm alarm,
+		systime_alarm_callback_t callback)
+{
+	Assert(alarm < SYSTIME_NR_OF_ALARMS);
+	systime_alarm_callback[alarm] = callback;
+}
+
+/**
+ * \brief Set an alarm
+ *
+ * Replaces the previous time of the alarm. A time that has already passed
+ * fires the alarm right away. Safe to call from interrupts.
+ *
+ * \param alarm the alarm
+ * \param at the clock time to fire at, at most 35 minutes ahead
+ */
+void systime_alarm_set(enum systime_alarm alarm, uint32_t at)
+{
+	irqflags_t flags;
+
+	Assert(systime_alarm_callback[alarm]);
+
+	flags = cpu_irq_save();
+	systime_alarm_at[alarm] = at;
+	systime_alarm_update(alarm);
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Cancel an alarm
+ *
+ * \param alarm the alarm
+ */
+void systime_alarm_cancel(enum systime_alarm alarm)
+{
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	systime_alarm_set_level(&CONFIG_SYSTIME_TC_HIGH, alarm, TC_INT_LVL_OFF);
+	systime_alarm_set_level(&CONFIG_SYSTIME_TC_LOW, alarm, TC_INT_LVL_OFF);
+	cpu_irq_restore(flags);
+}
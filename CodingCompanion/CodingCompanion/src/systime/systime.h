@@ -0,0 +1,80 @@
+/**
+ * \file
+ *
+ * \brief 32-bit monotonic microsecond clock
+ *
+ * The low timer counter of conf_systime.h counts microseconds and its
+ * overflow is routed through the event system to clock the high one, so the
+ * pair forms a 32-bit counter with no interrupt load. The clock wraps every
+ * 71.6 minutes; compare times with systime_elapsed() or systime_is_reached()
+ * rather than with < or >.
+ *
+ * The compare channels of the two counters double as alarms: an alarm
+ * further out than the current 65.536 ms period of the low counter first
+ * waits on the high counter, so a far alarm costs two interrupts in total.
+ */
+#ifndef SYSTIME_H_INCLUDED
+#define SYSTIME_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_systime.h>
+
+//! Clock ticks per second
+#define SYSTIME_TICKS_PER_SEC  1000000UL
+
+//! Convert microseconds to clock ticks
+#define SYSTIME_US(us)  ((uint32_t)(us))
+//! Convert milliseconds to clock ticks
+#define SYSTIME_MS(ms)  ((uint32_t)(ms) * 1000UL)
+//! Convert seconds to clock ticks, up to 4294 s
+#define SYSTIME_S(s)    ((uint32_t)(s) * 1000000UL)
+
+//! Alarm channels
+enum systime_alarm {
+	//! Used by the task scheduler
+	SYSTIME_ALARM_SCHED,
+	//! Used by the software timers
+	SYSTIME_ALARM_SOFT_TIMER,
+	SYSTIME_NR_OF_ALARMS,
+};
+
+//! Alarm callback, runs from the compare interrupt at the low level
+typedef void (*systime_alarm_callback_t)(void);
+
+void systime_init(void);
+uint32_t systime_now(void);
+void systime_alarm_init(enum systime_alarm alarm,
+		systime_alarm_callback_t callback);
+void systime_alarm_set(enum systime_alarm alarm, uint32_t at);
+void systime_alarm_cancel(enum systime_alarm alarm);
+
+/**
+ * \brief Time passed since an earlier reading
+ *
+ * \param since an earlier value of systime_now()
+ *
+ * \retval microseconds since \a since, correct across one wrap of the clock
+ */
+static inline uint32_t systime_elapsed(uint32_t since)
+{
+	return systime_now() - since;
+}
+
+/**
+ * \brief Check whether a point in time has been reached
+ *
+ * \param at the time to check, at most 35 minutes away from \a now
+ * \param now the current time
+ */
+static inline bool systime_is_reached(uint32_t at, uint32_t now)
+{
+	return (int32_t)(at - now) <= 0;
+}
+
+//! \brief Convert clock ticks to milliseconds, rounded down
+static inline uint32_t systime_to_ms(uint32_t ticks)
+{
+	return ticks / 1000;
+}
+
+#endif /* SYSTIME_H_INCLUDED */
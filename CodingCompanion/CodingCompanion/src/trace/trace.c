@@ -0,0 +1,349 @@
+/**
+ * \file
+ *
+ * \brief Sensor input record and replay
+ *
+ */
+#include <asf.h>
+#include <console/console.h>
+#include <adc_sched/adc_sched.h>
+#include <lockfree/lockfree.h>
+#include "trace.h"
+
+#if defined(CONFIG_TRACE_CAPTURE) || defined(CONFIG_TRACE_REPLAY)
+
+//! \internal Current main loop iteration
+static uint32_t trace_loop;
+
+#ifdef CONFIG_TRACE_CAPTURE
+
+/**
+ * \internal
+ * \brief Event as queued by the interrupt handlers
+ *
+ * The loop number is added when the event is drained by trace_loop_end(), so
+ * the interrupts never read the main loop counter.
+ */
+struct trace_event {
+	uint8_t type;
+	uint8_t id;
+	int16_t value;
+};
+
+static struct trace_event trace_buf[CONFIG_TRACE_BUFFER_SIZE];
+/* Filled by the deferred ADC callback and the button interrupt, which can
+ * preempt it, so each push is made with interrupts disabled to keep one
+ * producer at a time. */
+static struct lf_ring trace_ring;
+//! \internal Events lost to a full ring, only written by the producers
+static volatile uint8_t trace_dropped;
+
+/**
+ * \internal
+ * \brief Queue an event from any context
+ */
+static void trace_log(uint8_t type, uint8_t id, int16_t value)
+{
+	struct trace_event event = {
+		.type = type,
+		.id = id,
+		.value = value,
+	};
+	irqflags_t flags;
+
+	flags = cpu_irq_save();
+	if (!lf_ring_push(&trace_ring, &event)) {
+		trace_dropped++;
+	}
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Start capturing
+ */
+void trace_init(void)
+{
+	lf_ring_init(&trace_ring, trace_buf, sizeof(trace_buf[0]),
+			CONFIG_TRACE_BUFFER_SIZE);
+	console_init();
+	console_puts("T capture\r\n");
+}
+
+/**
+ * \brief Mark the start of a main loop iteration
+ */
+void trace_loop_begin(void)
+{
+	trace_loop++;
+}
+
+/**
+ * \brief Write the events of this iteration to the console
+ *
+ * Lost events are reported with a "D <count>" line, so a lossy capture is
+ * not mistaken for a complete one.
+ */
+void trace_loop_end(void)
+{
+	static uint8_t reported_dropped;
+	struct trace_event event;
+	uint8_t dropped;
+
+	while (lf_ring_pop(&trace_ring, &event)) {
+		console_printf("%c %lu %u %d\r\n", event.type, trace_loop, event.id,
+				event.value);
+	}
+
+	dropped = trace_dropped;
+	if (dropped != reported_dropped) {
+		console_printf("D %u\r\n", (uint8_t)(dropped - reported_dropped));
+		reported_dropped = dropped;
+	}
+}
+
+/**
+ * \brief Log a raw ADC result
+ *
+ * \param sensor the scheduler id of the sensor
+ * \param result the conversion result
+ *
+ * \retval \a result, unchanged
+ */
+adc_result_t trace_adc(uint8_t sensor, adc_result_t result)
+{
+	trace_log(TRACE_TYPE_ADC, sensor, result);
+	return result;
+}
+
+/**
+ * \brief Log a button level if it changed
+ *
+ * \param button the button number
+ * \param level the level read from the pin
+ *
+ * \retval \a level, unchanged
+ */
+bool trace_button(uint8_t button, bool level)
+{
+	static uint8_t known;
+	static uint8_t levels;
+	uint8_t mask = 1 << button;
+
+	if (!(known & mask) || (!!(levels & mask) != level)) {
+		trace_log(TRACE_TYPE_BUTTON, button, level);
+		known |= mask;
+		levels = level ? (levels | mask) : (levels & ~mask);
+	}
+	return level;
+}
+
+#else /* CONFIG_TRACE_REPLAY */
+
+#include <avr/pgmspace.h>
+#include "trace_data.h"
+
+//! \internal Number of records in trace_data
+#define TRACE_DATA_LENGTH (sizeof(trace_data) / sizeof(trace_data[0]))
+
+#if TRACE_ADC_NR_OF_SENSORS > CONFIG_ADC_SCHED_MAX_SENSORS
+#  error trace_data.h has more sensors than the ADC scheduler
+#endif
+
+//! \internal Next result to replay, per sensor
+static uint16_t trace_adc_pos[CONFIG_ADC_SCHED_MAX_SENSORS];
+//! \internal Next button record to apply
+static uint16_t trace_button_pos;
+//! \internal Replayed button levels, and which buttons have one
+static volatile uint8_t trace_button_known;
+static volatile uint8_t trace_button_levels;
+
+//! \internal Loop statistics, cycle counts are in timer ticks
+static uint16_t trace_loop_start;
+static uint32_t trace_loops;
+static uint64_t trace_ticks_total;
+static uint16_t trace_ticks_max;
+static bool trace_done;
+
+//! \internal Serial clock edges of the LCD counted so far, and the last count
+static uint32_t trace_lcd_clocks;
+static uint16_t trace_lcd_count;
+
+//! \internal Event multiplexer of the channel carrying the LCD clock
+#define TRACE_LCD_EVSYS_CHMUX \
+	(*(&EVSYS.CH0MUX + CONFIG_TRACE_LCD_EVSYS_CH))
+//! \internal Clock source of the timer counting the LCD clock
+#define TRACE_LCD_CLKSEL \
+	((TC_CLKSEL_t)(TC_CLKSEL_EVCH0_gc + CONFIG_TRACE_LCD_EVSYS_CH))
+
+//! \internal Timer used to count cycles, and its prescaler
+#define TRACE_TC       TCE0
+#define TRACE_TC_DIV   8
+
+/**
+ * \internal
+ * \brief Read a record from flash
+ */
+static void trace_read(uint16_t pos, struct trace_record *record)
+{
+	memcpy_P(record, &trace_data[pos], sizeof(*record));
+}
+
+/**
+ * \internal
+ * \brief Add the LCD clock edges counted since the last call
+ *
+ * Called at least once a loop, well before the 16-bit count wraps.
+ */
+static void trace_lcd_update(void)
+{
+	uint16_t count = tc_read_count(&CONFIG_TRACE_LCD_TC);
+
+	trace_lcd_clocks += (uint16_t)(count - trace_lcd_count);
+	trace_lcd_count = count;
+}
+
+/**
+ * \brief Start replaying
+ *
+ * Starts the cycle counter. It runs at CPU clock / 8, so a loop can take up
+ * to 524288 cycles before the count wraps.
+ *
+ * Also starts counting the rising edges of the LCD serial clock, eight to
+ * a byte. The pin is sensed while the USART drives it, so every command
+ * and data byte is counted without a hook in the display driver.
+ */
+void trace_init(void)
+{
+	for (uint8_t sensor = 0; sensor < TRACE_ADC_NR_OF_SENSORS; sensor++) {
+		trace_adc_pos[sensor] = pgm_read_word(&trace_adc_first[sensor]);
+	}
+
+	tc_enable(&TRACE_TC);
+	tc_set_wgm(&TRACE_TC, TC_WG_NORMAL);
+	tc_write_period(&TRACE_TC, 0xffff);
+	tc_write_clock_source(&TRACE_TC, TC_CLKSEL_DIV8_gc);
+
+	PORTD.PIN1CTRL = (PORTD.PIN1CTRL & ~PORT_ISC_gm) | PORT_ISC_RISING_gc;
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_EVSYS);
+	TRACE_LCD_EVSYS_CHMUX = CONFIG_TRACE_LCD_CHMUX;
+	tc_enable(&CONFIG_TRACE_LCD_TC);
+	tc_set_wgm(&CONFIG_TRACE_LCD_TC, TC_WG_NORMAL);
+	tc_write_period(&CONFIG_TRACE_LCD_TC, 0xffff);
+	tc_write_count(&CONFIG_TRACE_LCD_TC, 0);
+	tc_write_clock_source(&CONFIG_TRACE_LCD_TC, TRACE_LCD_CLKSEL);
+
+	console_init();
+	console_printf("T replay %u\r\n", (uint16_t)TRACE_DATA_LENGTH);
+}
+
+/**
+ * \brief Mark the start of a main loop iteration
+ *
+ * Applies the button edges recorded for this iteration, and prints the report
+ * once the whole trace has been replayed.
+ */
+void trace_loop_begin(void)
+{
+	struct trace_record record;
+
+	trace_loop++;
+
+	for (; trace_button_pos < TRACE_DATA_LENGTH; trace_button_pos++) {
+		trace_read(trace_button_pos, &record);
+		if (record.loop > trace_loop) {
+			break;
+		}
+		if (record.type == TRACE_TYPE_BUTTON) {
+			uint8_t mask = 1 << record.id;
+
+			trace_button_levels = record.value
+					? (trace_button_levels | mask)
+					: (trace_button_levels & ~mask);
+			trace_button_known |= mask;
+		}
+	}
+
+	if (!trace_done && trace_button_pos == TRACE_DATA_LENGTH) {
+		trace_read(TRACE_DATA_LENGTH - 1, &record);
+		if (trace_loop > record.loop) {
+			trace_done = true;
+			console_printf("R loops %lu\r\n", trace_loops);
+			console_printf("R cycles_avg %lu\r\n", (uint32_t)(trace_ticks_total
+					* TRACE_TC_DIV / trace_loops));
+			console_printf("R cycles_max %lu\r\n",
+					(uint32_t)trace_ticks_max * TRACE_TC_DIV);
+			trace_lcd_update();
+			console_printf("R lcd_bytes %lu\r\n", trace_lcd_clocks / 8);
+		}
+	}
+
+	trace_loop_start = tc_read_count(&TRACE_TC);
+}
+
+/**
+ * \brief Mark the end of a main loop iteration
+ */
+void trace_loop_end(void)
+{
+	uint16_t ticks = tc_read_count(&TRACE_TC) - trace_loop_start;
+
+	trace_lcd_update();
+	if (trace_done) {
+		return;
+	}
+	trace_loops++;
+	trace_ticks_total += ticks;
+	if (ticks > trace_ticks_max) {
+		trace_ticks_max = ticks;
+	}
+}
+
+/**
+ * \brief Replace an ADC result with the next recorded one
+ *
+ * The results of each sensor are stored together in trace_adc_values, so
+ * the next one is read directly at the position of the sensor.
+ *
+ * \param sensor the scheduler id of the sensor
+ * \param result the live conversion result
+ *
+ * \retval the recorded result, or \a result once the trace has run out
+ */
+adc_result_t trace_adc(uint8_t sensor, adc_result_t result)
+{
+	uint16_t pos;
+
+	Assert(sensor < CONFIG_ADC_SCHED_MAX_SENSORS);
+
+	if (sensor >= TRACE_ADC_NR_OF_SENSORS) {
+		return result;
+	}
+	pos = trace_adc_pos[sensor];
+	if (pos < pgm_read_word(&trace_adc_first[sensor + 1])) {
+		result = (int16_t)pgm_read_word(&trace_adc_values[pos]);
+		trace_adc_pos[sensor] = pos + 1;
+	}
+	return result;
+}
+
+/**
+ * \brief Replace a button level with the recorded one
+ *
+ * \param button the button number
+ * \param level the level read from the pin
+ *
+ * \retval the recorded level, or \a level if there is none for the button
+ */
+bool trace_button(uint8_t button, bool level)
+{
+	uint8_t mask = 1 << button;
+
+	if (trace_button_known & mask) {
+		return trace_button_levels & mask;
+	}
+	return level;
+}
+
+#endif /* CONFIG_TRACE_CAPTURE */
+
+#endif /* CONFIG_TRACE_CAPTURE || CONFIG_TRACE_REPLAY */
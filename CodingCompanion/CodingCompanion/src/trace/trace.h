@@ -0,0 +1,86 @@
+/**
+ * \file
+ *
+ * \brief Sensor input record and replay
+ *
+ * In capture mode (CONFIG_TRACE_CAPTURE) every raw ADC result and every edge
+ * of a traced button is logged to the console as one text line:
+ *
+ * \code
+ * A <loop> <sensor> <value>
+ * B <loop> <button> <level>
+ * \endcode
+ *
+ * Timestamps are main loop iterations, counted by trace_loop_begin(). That
+ * keeps replay deterministic no matter how fast the firmware under test runs.
+ *
+ * In replay mode (CONFIG_TRACE_REPLAY) the same hooks return the values of
+ * the trace compiled in from trace_data.h instead of the live inputs, while
+ * the hardware keeps converting so timing stays realistic. Each loop is timed
+ * in CPU cycles, and the bytes sent to the LCD are counted from its serial
+ * clock on a timer, so the display driver needs no hook; the totals are
+ * printed when the trace runs out. tools/trace_tool.py converts a captured
+ * log to trace_data.h and parses the report.
+ *
+ * With neither mode configured the hooks compile to nothing.
+ */
+#ifndef TRACE_H_INCLUDED
+#define TRACE_H_INCLUDED
+
+#include <compiler.h>
+#include <adc.h>
+#include <conf_trace.h>
+
+#if defined(CONFIG_TRACE_CAPTURE) && defined(CONFIG_TRACE_REPLAY)
+#  error CONFIG_TRACE_CAPTURE and CONFIG_TRACE_REPLAY are exclusive
+#endif
+
+//! Type of a trace record
+enum trace_type {
+	TRACE_TYPE_ADC = 'A',
+	TRACE_TYPE_BUTTON = 'B',
+};
+
+//! One traced input event
+struct trace_record {
+	uint32_t loop;
+	uint8_t type;
+	uint8_t id;
+	int16_t value;
+};
+
+#if defined(CONFIG_TRACE_CAPTURE) || defined(CONFIG_TRACE_REPLAY)
+
+void trace_init(void);
+void trace_loop_begin(void);
+void trace_loop_end(void);
+adc_result_t trace_adc(uint8_t sensor, adc_result_t result);
+bool trace_button(uint8_t button, bool level);
+
+#else
+
+static inline void trace_init(void)
+{
+}
+
+static inline void trace_loop_begin(void)
+{
+}
+
+static inline void trace_loop_end(void)
+{
+}
+
+static inline adc_result_t trace_adc(uint8_t sensor, adc_result_t result)
+{
+	return result;
+}
+
+static inline bool trace_button(uint8_t button, bool level)
+{
+	return level;
+}
+
+#endif
+
+#endif /* TRACE_H_INCLUDED */
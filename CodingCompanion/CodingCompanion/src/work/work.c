@@ -0,0 +1,120 @@
+/**
+ * \file
+ *
+ * \brief Deferred work queues
+ *
+ */
+#include <asf.h>
+#include "work.h"
+
+//! \internal First and last pending item of each queue
+static struct work *work_head[WORK_NR_OF_PRIORITIES];
+static struct work *work_tail[WORK_NR_OF_PRIORITIES];
+
+/**
+ * \internal
+ * \brief Take the next item off the highest priority queue that has one
+ *
+ * \note Must be called with interrupts disabled.
+ *
+ * \retval NULL if all queues are empty
+ */
+static struct work *work_take(void)
+{
+	struct work *work;
+
+	for (uint8_t prio = 0; prio < WORK_NR_OF_PRIORITIES; prio++) {
+		work = work_head[prio];
+		if (work) {
+			work_head[prio] = work->next;
+			work->queued = false;
+			return work;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \brief Initialize the work queues and the interrupt scheduling
+ *
+ * \note pmic_init() must be called first.
+ */
+void work_init(void)
+{
+	for (uint8_t prio = 0; prio < WORK_NR_OF_PRIORITIES; prio++) {
+		work_head[prio] = NULL;
+		work_tail[prio] = NULL;
+	}
+
+#ifdef CONFIG_WORK_PMIC_ROUND_ROBIN
+	pmic_set_scheduling(PMIC_SCH_ROUND_ROBIN);
+#else
+	pmic_set_scheduling(PMIC_SCH_FIXED_PRIORITY);
+#endif
+}
+
+/**
+ * \brief Queue a work item at the end of its queue
+ *
+ * Does nothing if the item is already pending. Safe to call from interrupts
+ * and from work handlers.
+ *
+ * \param work the work item, with \a fn and \a priority set
+ */
+void work_post(struct work *work)
+{
+	irqflags_t flags;
+
+	Assert(work->fn);
+	Assert(work->priority < WORK_NR_OF_PRIORITIES);
+
+	flags = cpu_irq_save();
+	if (!work->queued) {
+		work->next = NULL;
+		if (work_head[work->priority]) {
+			work_tail[work->priority]->next = work;
+		} else {
+			work_head[work->priority] = work;
+		}
+		work_tail[work->priority] = work;
+		work->queued = true;
+	}
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Check whether any work item is pending
+ *
+ * \note To sleep on the result, call with interrupts disabled.
+ */
+bool work_is_pending(void)
+{
+	for (uint8_t prio = 0; prio < WORK_NR_OF_PRIORITIES; prio++) {
+		if (work_head[prio]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * \brief Run the pending work items until all queues are empty
+ *
+ * Items run one at a time with interrupts enabled. After each one the
+ * queues are searched again from the highest priority, so an item posted
+ * meanwhile runs ahead of any lower priority items still waiting.
+ */
+void work_run(void)
+{
+	struct work *work;
+
+	while (1) {
+		cpu_irq_disable();
+		work = work_take();
+		cpu_irq_enable();
+		if (!work) {
+			return;
+		}
+		work->fn();
+	}
+}
@@ -0,0 +1,55 @@
+/**
+ * \file
+ *
+ * \brief Deferred work queues
+ *
+ * Lets an interrupt handler capture what it must and post the rest of its
+ * work to run in the main context, where it may take longer without
+ * holding back other interrupts. There is one FIFO queue per priority, and
+ * sched_run() drains them before it runs the next task or sleeps, always
+ * taking the next item from the highest priority queue that has one.
+ *
+ * A work item is queued at most once, so posting one that is still pending
+ * does nothing and the handler runs once for both posts. The handler must
+ * therefore pick up everything captured since it last ran.
+ *
+ * With CONFIG_WORK_PMIC_ROUND_ROBIN the interrupt controller serves the
+ * pending low level interrupts in turn.
+ */
+#ifndef WORK_H_INCLUDED
+#define WORK_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_work.h>
+
+//! Work queues, drained from the first
+enum work_priority {
+	WORK_PRIORITY_HIGH,
+	WORK_PRIORITY_MEDIUM,
+	WORK_PRIORITY_LOW,
+	WORK_NR_OF_PRIORITIES,
+};
+
+//! Work handler, runs to completion in the main context
+typedef void (*work_fn_t)(void);
+
+/**
+ * \brief Work item
+ *
+ * Owned by the caller and linked into its queue while pending. Only \a fn
+ * and \a priority are set by the caller, the rest is private to the queues.
+ */
+struct work {
+	work_fn_t fn;
+	enum work_priority priority;
+	//! Next item in the same queue
+	struct work *next;
+	bool queued;
+};
+
+void work_init(void);
+void work_post(struct work *work);
+bool work_is_pending(void);
+void work_run(void);
+
+#endif /* WORK_H_INCLUDED */
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Capture, convert and report sensor traces of the Coding Companion.
+
+Build the firmware with CONFIG_TRACE_CAPTURE in conf_trace.h, then:
+
+    trace_tool.py capture COM5 run.log        # record until Ctrl-C
+    trace_tool.py convert run.log ../src/trace/trace_data.h
+
+Rebuild with CONFIG_TRACE_REPLAY instead, flash, and:
+
+    trace_tool.py report COM5                 # wait for the replay report
+
+The serial port is the board controller's virtual COM port (USARTC0).
+"""
+
+import argparse
+import sys
+
+BAUDRATE = 38400
+
+
+def open_port(port):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("pyserial is required: pip install pyserial")
+    return serial.Serial(port, BAUDRATE, timeout=1)
+
+
+def read_lines(port):
+    buf = b""
+    while True:
+        buf += port.read(port.in_waiting or 1)
+        while b"\n" in buf:
+            line, buf = buf.split(b"\n", 1)
+            yield line.decode("ascii", "replace").strip()
+
+
+def parse_record(line):
+    """Split a trace record line, or return None if it is something else.
+
+    Only "A" and "B" lines of four fields are records, the console prints
+    other lines in between.
+    """
+    fields = line.split()
+    if len(fields) == 4 and fields[0] in ("A", "B"):
+        return fields
+    return None
+
+
+def capture(args):
+    dropped = 0
+    records = 0
+    with open_port(args.port) as port, open(args.log, "w") as log:
+        try:
+            for line in read_lines(port):
+                if not line:
+                    continue
+                log.write(line + "\n")
+                if line.startswith("D "):
+                    dropped += int(line.split()[1])
+                elif parse_record(line):
+                    records += 1
+        except KeyboardInterrupt:
+            pass
+    print("%d records captured" % records)
+    if dropped:
+        print("warning: %d records dropped, increase CONFIG_TRACE_BUFFER_SIZE"
+              % dropped)
+
+
+def convert(args):
+    records = []
+    with open(args.log) as log:
+        for line in log:
+            fields = line.split()
+            if parse_record(line):
+                records.append((int(fields[1]), fields[0], int(fields[2]),
+                                int(fields[3])))
+            elif fields and fields[0] == "D":
+                sys.exit("%s: capture dropped records, replay would diverge"
+                         % args.log)
+    if not records:
+        sys.exit("%s: no records" % args.log)
+
+    with open(args.header, "w", newline="\r\n") as out:
+        out.write("/**\n * \\file\n *\n * \\brief Sensor trace for replay\n"
+                  " *\n * Generated by tools/trace_tool.py from %s.\n */\n"
+                  % args.log)
+        out.write("#include <compiler.h>\n\n")
+        out.write("static const struct trace_record trace_data[] PROGMEM = {\n")
+        for loop, kind, ident, value in records:
+            out.write("\t{%d, '%s', %d, %d},\n" % (loop, kind, ident, value))
+        out.write("};\n")
+
+        # ADC results again, grouped by sensor, so replay reads the next
+        # result of a sensor directly rather than searching for it
+        adc = [(ident, value) for _, kind, ident, value in records
+               if kind == "A"]
+        sensors = max([ident for ident, _ in adc], default=-1) + 1
+        first = [0]
+        values = []
+        for sensor in range(sensors):
+            values += [value for ident, value in adc if ident == sensor]
+            first.append(len(values))
+        out.write("\n#define TRACE_ADC_NR_OF_SENSORS %d\n\n" % sensors)
+        out.write("static const uint16_t trace_adc_first[] PROGMEM = {\n")
+        out.write("\t%s,\n};\n\n" % ", ".join(str(pos) for pos in first))
+        out.write("static const int16_t trace_adc_values[] PROGMEM = {\n")
+        for value in values or [0]:
+            out.write("\t%d,\n" % value)
+        out.write("};\n")
+    print("%d records written to %s" % (len(records), args.header))
+
+
+def report(args):
+    results = {}
+    with open_port(args.port) as port:
+        for line in read_lines(port):
+            if line.startswith("T "):
+                print(line[2:])
+            elif line.startswith("R "):
+                key, value = line[2:].split()
+                results[key] = int(value)
+                if key == "lcd_bytes":
+                    break
+
+    loops = results.get("loops", 0)
+    print("loops replayed  %d" % loops)
+    print("cycles/loop avg %d" % results.get("cycles_avg", 0))
+    print("cycles/loop max %d" % results.get("cycles_max", 0))
+    print("LCD bytes       %d" % results.get("lcd_bytes", 0))
+    if loops:
+        print("LCD bytes/loop  %.1f" % (results.get("lcd_bytes", 0) / loops))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("capture", help="record a trace from the board")
+    p.add_argument("port")
+    p.add_argument("log")
+    p.set_defaults(func=capture)
+
+    p = sub.add_parser("convert", help="turn a captured log into trace_data.h")
+    p.add_argument("log")
+    p.add_argument("header")
+    p.set_defaults(func=convert)
+
+    p = sub.add_parser("report", help="print the report of a replay run")
+    p.add_argument("port")
+    p.set_defaults(func=report)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,16 @@
+/**
+ * \file
+ *
+ * \brief Sleeping delay configuration
+ *
+ */
+#ifndef CONF_SLEEP_DELAY_H
+#define CONF_SLEEP_DELAY_H
+
+// Timer counter the delays are timed on, TCC0 drives the PWM
+#define CONFIG_SLEEP_DELAY_TC      TCD0
+
+// Shortest delay that is slept, shorter ones are counted in CPU cycles
+#define CONFIG_SLEEP_DELAY_MIN_US  10
+
+#endif /* CONF_SLEEP_DELAY_H */
@@ -32,6 +32,8 @@
 #include <stdio.h>
 #include <ioport.h>
 #include <board.h>
+#include <pwm/pwm.h>
+#include <sleep_delay/sleep_delay.h>
 
 #define MY_ADC ADCA
 #define MY_ADC_CH ADC_CH0
@@ -54,33 +56,25 @@ static void adc_init(void)
 
 	adc_write_configuration(&MY_ADC, &adc_conf);
 	adcch_write_configuration(&MY_ADC, MY_ADC_CH, &adcch_conf);
+
+	// Once only, each adc_enable() takes another sleep manager lock
+	adc_enable(&MY_ADC);
 }
 
 static uint16_t adc_read()
 {
 	uint16_t result;
-	adc_enable(&MY_ADC);
 	adc_start_conversion(&MY_ADC, MY_ADC_CH);
 	adc_wait_for_interrupt_flag(&MY_ADC, MY_ADC_CH);
 	result = adc_get_result(&MY_ADC, MY_ADC_CH);
 	return result;
 }
 
-void PWM_Init(void)
-{
-	/* Set output */
-	PORTC.DIR |= PIN0_bm;
+/* PWM frequency, one period is 10000 counts of the 2 MHz peripheral clock */
+#define PWM_FREQ_HZ 200
 
-	/* Set Register */
-	TCC0.CTRLA = (PIN2_bm) | (PIN0_bm);
-	TCC0.CTRLB = (PIN4_bm) | (PIN2_bm) | (PIN1_bm);
-
-	/* Set Period */
-	TCC0.PER = 10000;
-
-	/* Set Compare Register value*/
-	TCC0.CCA = 0;
-}
+static struct pwm pwm;
+static struct pwm_map pwm_map_adc;
 
 int main(void)
 {
@@ -88,18 +82,32 @@ int main(void)
 
 	board_init();
 
+	sysclk_init();
+
+	sleepmgr_init();
+
+	pmic_init();
+
 	gfx_mono_init();
 
 	adc_init();
 
-	PWM_Init();
+	/* PWM on OC0A (PC0), duty cycle updates land at the start of a period */
+	pwm_init(&pwm, &TCC0, PWM_FREQ_HZ, false);
+	pwm_enable_channel(&pwm, TC_CCA);
+	pwm_start(&pwm);
+
+	/* The loop is paced by sleeping on a timer instead of counting cycles */
+	sleep_delay_init();
+	cpu_irq_enable();
 
 	uint32_t result;
 	uint32_t max = 2000;
 	uint32_t min = 2000;
-	uint32_t period = 10000;
 	uint32_t final = 0;
 
+	pwm_map_init(&pwm_map_adc, &pwm, min, max);
+
 	ioport_set_pin_level(LCD_BACKLIGHT_ENABLE_PIN, 1);
 
 	while (1)
@@ -109,28 +117,30 @@ int main(void)
 		snprintf(strbuf, sizeof(strbuf), "ADC: %4lu", result);
 		gfx_mono_draw_string(strbuf, 0, 0, &sysfont);
 
+		/* The range only changes while it is being calibrated, so the
+		 * division of the mapping is done once per change */
 		if (result > max)
 		{
 			max = result;
+			pwm_map_init(&pwm_map_adc, &pwm, min, max);
 		}
 		else if (result < min)
 		{
 			min = result;
+			pwm_map_init(&pwm_map_adc, &pwm, min, max);
 		}
 
 		snprintf(strbuf, sizeof(strbuf), "Max: %4lu Min: %4lu", max, min);
 		gfx_mono_draw_string(strbuf, 0, 8, &sysfont);
 
-		uint32_t result_normalized = (result - min) * period;
-		final = result_normalized / (max - min);
-
-		TCC0.CCA = final;
+		final = pwm_map(&pwm_map_adc, result);
+		pwm_set_duty(&pwm, TC_CCA, final);
 
-		snprintf(strbuf, sizeof(strbuf), "PWM: %5lu/10000", final);
+		snprintf(strbuf, sizeof(strbuf), "PWM: %5lu/%u", final, pwm.period);
 		gfx_mono_draw_string(strbuf, 0, 16, &sysfont);
 
-		delay_ms(50);
+		sleep_delay_ms(50);
 	}
 
 	/* Insert application code here, after the board has been initialized. */
-}
\ No newline at end of file
+}
@@ -0,0 +1,113 @@
+/**
+ * \file
+ *
+ * \brief Buffered PWM on the timer counters
+ *
+ */
+#ifndef PWM_H_INCLUDED
+#define PWM_H_INCLUDED
+
+#include <compiler.h>
+#include <status_codes.h>
+#include <tc.h>
+
+/**
+ * \brief PWM timer
+ *
+ * One timer counter in single slope mode, driving the output compare pins of
+ * its enabled channels: pins 0 to 3 of its port for a type 0 timer, pins 4
+ * and 5 for a type 1 timer.
+ */
+struct pwm {
+	//! Timer counter
+	volatile void *tc;
+	//! Timer period, the duty cycle of an output that is always high
+	uint16_t period;
+	//! Enabled channels, bit n for TC_CCA + n
+	uint8_t channels;
+	//! Prescaler the timer runs on when started
+	TC_CLKSEL_t clksel;
+};
+
+/**
+ * \brief Mapping from an input range to duty cycles
+ *
+ * Holds a precomputed reciprocal of the input range, so inputs are mapped
+ * with one multiplication and a shift.
+ */
+struct pwm_map {
+	//! Input mapped to duty cycle 0
+	uint16_t in_min;
+	//! Input mapped to the full period
+	uint16_t in_max;
+	//! Period divided by the input range, shifted left by \a shift
+	uint16_t scale;
+	//! Fraction bits of \a scale
+	uint8_t shift;
+	//! Duty cycle of \a in_max
+	uint16_t full;
+};
+
+status_code_t pwm_init(struct pwm *pwm, volatile void *tc, uint32_t freq_hz,
+		bool hires);
+void pwm_enable_channel(struct pwm *pwm, enum tc_cc_channel_t channel);
+void pwm_disable_channel(struct pwm *pwm, enum tc_cc_channel_t channel);
+void pwm_start(struct pwm *pwm);
+void pwm_stop(struct pwm *pwm);
+
+void pwm_map_init(struct pwm_map *map, const struct pwm *pwm,
+		uint16_t in_min, uint16_t in_max);
+
+/**
+ * \brief Set the duty cycle of a channel
+ *
+ * The value goes to the buffer register and takes effect at the start of the
+ * next period, so a period is never cut short or stretched.
+ *
+ * \param pwm the PWM timer
+ * \param channel the channel
+ * \param duty the duty cycle in timer counts, 0 to \a period
+ */
+static inline void pwm_set_duty(struct pwm *pwm,
+		enum tc_cc_channel_t channel, uint16_t duty)
+{
+	tc_write_cc_buffer(pwm->tc, channel, duty);
+}
+
+/**
+ * \brief Map an input to a duty cycle
+ *
+ * Inputs outside the range of the mapping are clamped to it.
+ *
+ * \param map the mapping, from pwm_map_init()
+ * \param in the input
+ *
+ * \retval the duty cycle in timer counts
+ */
+static inline uint16_t pwm_map(const struct pwm_map *map, uint16_t in)
+{
+	if (in <= map->in_min) {
+		return 0;
+	}
+	if (in >= map->in_max) {
+		return map->full;
+	}
+	return ((uint32_t)(uint16_t)(in - map->in_min) * map->scale) >> map->shift;
+}
+
+/**
+ * \brief Set the duty cycle of a channel from an input
+ *
+ * \param pwm the PWM timer
+ * \param channel the channel
+ * \param map the mapping from the input to the duty cycle
+ * \param in the input
+ */
+static inline void pwm_set_mapped(struct pwm *pwm,
+		enum tc_cc_channel_t channel, const struct pwm_map *map,
+		uint16_t in)
+{
+	pwm_set_duty(pwm, channel, pwm_map(map, in));
+}
+
+#endif /* PWM_H_INCLUDED */
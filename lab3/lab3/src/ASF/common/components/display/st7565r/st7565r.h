@@ -229,6 +229,34 @@ static inline void st7565r_write_data(uint8_t data)
 #endif
 }
 
+/**
+ * \brief Write a run of data to the display controller
+ *
+ * Same as calling st7565r_write_data() for each byte, but the controller is
+ * selected and pin A0 set only once, so the bytes are streamed back to back.
+ *
+ * \param data the data to write
+ * \param len number of bytes to write
+ */
+static inline void st7565r_write_data_buffer(const uint8_t *data, uint8_t len)
+{
+#if defined(ST7565R_USART_SPI_INTERFACE)
+	struct usart_spi_device device = {.id = ST7565R_CS_PIN};
+	usart_spi_select_device(ST7565R_USART_SPI, &device);
+	ioport_set_pin_high(ST7565R_A0_PIN);
+	usart_spi_write_packet(ST7565R_USART_SPI, data, len);
+	ioport_set_pin_low(ST7565R_A0_PIN);
+	usart_spi_deselect_device(ST7565R_USART_SPI, &device);
+#elif defined(ST7565R_SPI_INTERFACE)
+	struct spi_device device = {.id = ST7565R_CS_PIN};
+	spi_select_device(ST7565R_SPI, &device);
+	ioport_set_pin_high(ST7565R_A0_PIN);
+	spi_write_packet(ST7565R_SPI, data, len);
+	ioport_set_pin_low(ST7565R_A0_PIN);
+	spi_deselect_device(ST7565R_SPI, &device);
+#endif
+}
+
 /**
  * \brief Read data from the controller
  *
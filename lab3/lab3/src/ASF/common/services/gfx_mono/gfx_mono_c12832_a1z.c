@@ -33,6 +33,7 @@
 /*
  * Support and FAQ: visit <a href="https://www.microchip.com/support/">Microchip Support</a>
  */
+#include <string.h>
 #include "gfx_mono_c12832_a1z.h"
 
 /* If we are using a serial interface without readback, use framebuffer */
@@ -52,8 +53,10 @@ static uint8_t framebuffer[GFX_MONO_LCD_FRAMEBUFFER_SIZE];
  */
 void gfx_mono_st7565r_init(void)
 {
+#ifndef CONFIG_ST7565R_FRAMEBUFFER
 	uint8_t page;
 	uint8_t column;
+#endif
 
 #ifdef CONFIG_ST7565R_FRAMEBUFFER
 	gfx_mono_set_framebuffer(framebuffer);
@@ -66,14 +69,19 @@ void gfx_mono_st7565r_init(void)
 	st7565r_set_display_start_line_address(0);
 
 	/* Clear the contents of the display.
-	 * If using a framebuffer (SPI interface) it will both clear the
-	 * controller memory and the framebuffer.
+	 * If using a framebuffer (SPI interface) it is cleared first and then
+	 * streamed to the controller a page at a time.
 	 */
+#ifdef CONFIG_ST7565R_FRAMEBUFFER
+	memset(framebuffer, 0x00, sizeof(framebuffer));
+	gfx_mono_st7565r_put_framebuffer();
+#else
 	for (page = 0; page < GFX_MONO_LCD_PAGES; page++) {
 		for (column = 0; column < GFX_MONO_LCD_WIDTH; column++) {
 			gfx_mono_put_byte(page, column, 0x00);
 		}
 	}
+#endif
 }
 
 /**
@@ -215,10 +223,7 @@ void gfx_mono_st7565r_put_page(gfx_mono_color_t *data, gfx_coord_t page,
 #endif
 	st7565r_set_page_address(page);
 	st7565r_set_column_address(column);
-
-	do {
-		st7565r_write_data(*data++);
-	} while (--width);
+	st7565r_write_data_buffer(data, width);
 }
 
 /**
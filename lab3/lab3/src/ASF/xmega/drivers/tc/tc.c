@@ -43,6 +43,7 @@
 #include "sysclk.h"
 #include "sleepmgr.h"
 #include "status_codes.h"
+#include "conf_tc.h"
 
 #if defined(TCC0) || defined(__DOXYGEN__)
 //! \internal Local storage of Timer Counter TCC0 interrupt callback function
@@ -54,6 +55,7 @@ static tc_callback_t tc_tcc0_ccc_callback;
 static tc_callback_t tc_tcc0_ccd_callback;
 
 
+#ifndef CONFIG_TC_TCC0_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C0 overflow
@@ -67,7 +69,9 @@ ISR(TCC0_OVF_vect)
 		tc_tcc0_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC0_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C0 error
@@ -81,7 +85,9 @@ ISR(TCC0_ERR_vect)
 		tc_tcc0_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC0_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C0 Compare/CaptureA
@@ -95,7 +101,9 @@ ISR(TCC0_CCA_vect)
 		tc_tcc0_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC0_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C0 Compare/CaptureB
@@ -109,7 +117,9 @@ ISR(TCC0_CCB_vect)
 		tc_tcc0_ccb_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC0_CCC_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C0 Compare/CaptureC
@@ -123,7 +133,9 @@ ISR(TCC0_CCC_vect)
 		tc_tcc0_ccc_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC0_CCD_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C0 Compare/CaptureD
@@ -137,6 +149,7 @@ ISR(TCC0_CCD_vect)
 		tc_tcc0_ccd_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -147,6 +160,7 @@ static tc_callback_t tc_tcc1_err_callback;
 static tc_callback_t tc_tcc1_cca_callback;
 static tc_callback_t tc_tcc1_ccb_callback;
 
+#ifndef CONFIG_TC_TCC1_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C1 overflow
@@ -160,7 +174,9 @@ ISR(TCC1_OVF_vect)
 		tc_tcc1_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC1_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C1 error
@@ -174,7 +190,9 @@ ISR(TCC1_ERR_vect)
 		tc_tcc1_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC1_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C1 Compare/CaptureA
@@ -188,7 +206,9 @@ ISR(TCC1_CCA_vect)
 		tc_tcc1_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCC1_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter C1 Compare/CaptureB
@@ -202,6 +222,7 @@ ISR(TCC1_CCB_vect)
 		tc_tcc1_ccb_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -215,6 +236,7 @@ static tc_callback_t tc_tcd0_ccc_callback;
 static tc_callback_t tc_tcd0_ccd_callback;
 
 
+#ifndef CONFIG_TC_TCD0_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D0 overflow
@@ -228,7 +250,9 @@ ISR(TCD0_OVF_vect)
 		tc_tcd0_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD0_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D0 error
@@ -242,7 +266,9 @@ ISR(TCD0_ERR_vect)
 		tc_tcd0_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD0_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D0 Compare/CaptureA
@@ -256,7 +282,9 @@ ISR(TCD0_CCA_vect)
 		tc_tcd0_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD0_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D0 Compare/CaptureB
@@ -270,7 +298,9 @@ ISR(TCD0_CCB_vect)
 		tc_tcd0_ccb_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD0_CCC_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D0 Compare/CaptureC
@@ -284,7 +314,9 @@ ISR(TCD0_CCC_vect)
 		tc_tcd0_ccc_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD0_CCD_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D0 Compare/CaptureD
@@ -298,6 +330,7 @@ ISR(TCD0_CCD_vect)
 		tc_tcd0_ccd_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -308,6 +341,7 @@ static tc_callback_t tc_tcd1_err_callback;
 static tc_callback_t tc_tcd1_cca_callback;
 static tc_callback_t tc_tcd1_ccb_callback;
 
+#ifndef CONFIG_TC_TCD1_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D1 overflow
@@ -321,7 +355,9 @@ ISR(TCD1_OVF_vect)
 		tc_tcd1_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD1_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D1 error
@@ -335,7 +371,9 @@ ISR(TCD1_ERR_vect)
 		tc_tcd1_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD1_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D1 Compare/CaptureA
@@ -349,7 +387,9 @@ ISR(TCD1_CCA_vect)
 		tc_tcd1_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCD1_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter D1 Compare/CaptureB
@@ -363,6 +403,7 @@ ISR(TCD1_CCB_vect)
 		tc_tcd1_ccb_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -377,6 +418,7 @@ static tc_callback_t tc_tce0_ccc_callback;
 static tc_callback_t tc_tce0_ccd_callback;
 
 
+#ifndef CONFIG_TC_TCE0_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E0 overflow
@@ -390,7 +432,9 @@ ISR(TCE0_OVF_vect)
 		tc_tce0_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE0_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E0 error
@@ -404,7 +448,9 @@ ISR(TCE0_ERR_vect)
 		tc_tce0_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE0_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E0 Compare/CaptureA
@@ -418,7 +464,9 @@ ISR(TCE0_CCA_vect)
 		tc_tce0_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE0_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E0 Compare/CaptureB
@@ -432,7 +480,9 @@ ISR(TCE0_CCB_vect)
 		tc_tce0_ccb_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE0_CCC_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E0 Compare/CaptureC
@@ -446,7 +496,9 @@ ISR(TCE0_CCC_vect)
 		tc_tce0_ccc_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE0_CCD_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E0 Compare/CaptureD
@@ -460,6 +512,7 @@ ISR(TCE0_CCD_vect)
 		tc_tce0_ccd_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -470,6 +523,7 @@ static tc_callback_t tc_tce1_err_callback;
 static tc_callback_t tc_tce1_cca_callback;
 static tc_callback_t tc_tce1_ccb_callback;
 
+#ifndef CONFIG_TC_TCE1_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E1 overflow
@@ -483,7 +537,9 @@ ISR(TCE1_OVF_vect)
 		tc_tce1_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE1_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E1 error
@@ -497,7 +553,9 @@ ISR(TCE1_ERR_vect)
 		tc_tce1_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE1_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E1 Compare/CaptureA
@@ -511,7 +569,9 @@ ISR(TCE1_CCA_vect)
 		tc_tce1_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCE1_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E1 Compare/CaptureB
@@ -525,6 +585,7 @@ ISR(TCE1_CCB_vect)
 		tc_tce1_ccb_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -538,6 +599,7 @@ static tc_callback_t tc_tcf0_ccc_callback;
 static tc_callback_t tc_tcf0_ccd_callback;
 
 
+#ifndef CONFIG_TC_TCF0_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter E0 overflow
@@ -551,7 +613,9 @@ ISR(TCF0_OVF_vect)
 		tc_tcf0_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF0_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F0 error
@@ -565,7 +629,9 @@ ISR(TCF0_ERR_vect)
 		tc_tcf0_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF0_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F0 Compare/CaptureA
@@ -579,7 +645,9 @@ ISR(TCF0_CCA_vect)
 		tc_tcf0_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF0_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F0 Compare/CaptureB
@@ -593,7 +661,9 @@ ISR(TCF0_CCB_vect)
 		tc_tcf0_ccb_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF0_CCC_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F0 Compare/CaptureC
@@ -607,7 +677,9 @@ ISR(TCF0_CCC_vect)
 		tc_tcf0_ccc_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF0_CCD_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F0 Compare/CaptureD
@@ -621,6 +693,7 @@ ISR(TCF0_CCD_vect)
 		tc_tcf0_ccd_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -631,6 +704,7 @@ static tc_callback_t tc_tcf1_err_callback;
 static tc_callback_t tc_tcf1_cca_callback;
 static tc_callback_t tc_tcf1_ccb_callback;
 
+#ifndef CONFIG_TC_TCF1_OVF_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F1 overflow
@@ -644,7 +718,9 @@ ISR(TCF1_OVF_vect)
 		tc_tcf1_ovf_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF1_ERR_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F1 error
@@ -658,7 +734,9 @@ ISR(TCF1_ERR_vect)
 		tc_tcf1_err_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF1_CCA_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F1 Compare/CaptureA
@@ -672,7 +750,9 @@ ISR(TCF1_CCA_vect)
 		tc_tcf1_cca_callback();
 	}
 }
+#endif
 
+#ifndef CONFIG_TC_TCF1_CCB_BOUND
 /**
  * \internal
  * \brief Interrupt handler for Timer Counter F1 Compare/CaptureB
@@ -686,6 +766,7 @@ ISR(TCF1_CCB_vect)
 		tc_tcf1_ccb_callback();
 	}
 }
+#endif
 
 #endif
 
@@ -0,0 +1,38 @@
+/**
+ * \file
+ *
+ * \brief Ultrasonic ranging configuration
+ *
+ */
+#ifndef CONF_RANGING_H
+#define CONF_RANGING_H
+
+// Port the sensors are on, and the event multiplexer input of its pin 0
+#define CONFIG_RANGING_PORT          PORTB
+#define CONFIG_RANGING_EVSYS_PIN0    EVSYS_CHMUX_PORTB_PIN0_gc
+// Pins of the sensors on the port, one bit per sensor
+#define CONFIG_RANGING_PINS          PIN0_bm
+
+// Timer counter used for capture and timing, and its clock for 1 us counts
+#define CONFIG_RANGING_TC            TCC0
+#define CONFIG_RANGING_TC_CLKSEL     TC_CLKSEL_DIV2_gc
+// Bind the handlers to the interrupt vectors of the timer counter at compile
+// time. The vectors must also be marked bound in conf_tc.h, under the names
+// given here; ranging.c checks that they are, and that they are not when
+// the handlers are not bound. Another timer needs all four changed.
+#define CONFIG_RANGING_TC_BOUND
+#define CONFIG_RANGING_TC_OVF_VECT   TCC0_OVF_vect
+#define CONFIG_RANGING_TC_CCA_VECT   TCC0_CCA_vect
+#define CONFIG_RANGING_TC_OVF_BOUND  CONFIG_TC_TCC0_OVF_BOUND
+#define CONFIG_RANGING_TC_CCA_BOUND  CONFIG_TC_TCC0_CCA_BOUND
+// Event channel the echo is routed through
+#define CONFIG_RANGING_EVSYS_CH      0
+
+// Longest echo to wait for, ~5 m
+#define CONFIG_RANGING_TIMEOUT_US    30000
+// Quiet time before the next trigger, lets the echoes of the last one fade
+#define CONFIG_RANGING_HOLDOFF_US    10000
+// Air temperature assumed until ranging_set_temperature() is called
+#define CONFIG_RANGING_TEMPERATURE   20
+
+#endif /* CONF_RANGING_H */
@@ -0,0 +1,22 @@
+/**
+ * \file
+ *
+ * \brief Timer counter driver configuration
+ *
+ */
+#ifndef CONF_TC_H
+#define CONF_TC_H
+
+// Timer interrupts whose handler is bound to the vector at compile time.
+// For each CONFIG_TC_<timer>_<interrupt>_BOUND defined here, tc.c leaves out
+// its ISR and the callback set with tc_set_*_interrupt_callback() is never
+// called; the module owning the timer defines ISR(<timer>_<interrupt>_vect)
+// itself instead. That saves the load, check and indirect call of the
+// callback, and the ISR only saves the registers the handler really uses.
+
+// Overflow and capture of the ranging timer, see conf_ranging.h. Defined
+// as 1 so ranging.c can check them through the names conf_ranging.h gives.
+#define CONFIG_TC_TCC0_OVF_BOUND  1
+#define CONFIG_TC_TCC0_CCA_BOUND  1
+
+#endif /* CONF_TC_H */
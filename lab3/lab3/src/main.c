@@ -30,38 +30,19 @@
  */
 #include <asf.h>
 #include <stdio.h>
+#include <ranging/ranging.h>
 
-void setup_timer(void);
-void print_message(void);
+//Jarak maksimum yang ditampilkan, dalam mm
+#define MAX_DISTANCE 3000
 
-int score = 0;
-int phase = 0;
-int incremental = 0;
-int distance = 0;
 static char buffarray[200];
 
-//Fungsi setup timer
-void setup_timer(void)
-{
-	tc_enable(&TCC0);
-	tc_set_overflow_interrupt_callback(&TCC0, print_message);
-	tc_set_wgm(&TCC0, TC_WG_NORMAL);
-	tc_write_period(&TCC0, 58);
-	tc_set_overflow_interrupt_level(&TCC0, TC_INT_LVL_HI);
-	tc_write_clock_source(&TCC0, TC_CLKSEL_DIV1_gc);
-}
-
-//Fungsi ini bukan utk print message, tapi increment nilai variabel "increment" setiap 29us
-void print_message(void)
-{
-	incremental = incremental + 1;
-}
-
 int main(void)
 {
 	// Insert system clock initialization code here (sysclk_init()).
 	board_init();
 	sysclk_init();
+	sleepmgr_init();
 	pmic_init();
 	gfx_mono_init();
 
@@ -74,55 +55,41 @@ int main(void)
 		// Wait for RTC32 sysclk to become stable
 	}
 
-	delay_ms(1000);
-	setup_timer();
+	//Sensor di-trigger bergantian, lebar pulsa echo diukur oleh timer lewat event system
+	ranging_init(NULL);
+	cpu_irq_enable();
+	ranging_start();
 
 	// Insert application code here, after the board has been initialized.
 	while (1)
 	{
-		PORTB.DIR = 0b11111111; //Set output
-		PORTB.OUT = 0b00000000; //Set low
-		PORTB.OUT = 0b11111111; //Set high selama 5us
-		delay_us(5);
-		PORTB.OUT = 0b00000000; //Kembali menjadi low
-		PORTB.DIR = 0b00000000; //Set menjadi input
-		delay_us(750);			//Delay holdoff selama 750us
-		int oldinc = incremental;
-		delay_us(115);	  //Delay lagi, kali ini seharusnya pin menjadi high
-		cpu_irq_enable(); //Mulai interrupt
-		while (PORTB.IN & PIN0_bm)
-		{
-			//Tidak ada apa-apa di sini. Loop ini berfungsi untuk mendeteksi pin 0 PORT B yang berubah menjadi low
-		}
-		int newinc = incremental; //Catat selisih waktu antara suara dikirim hingga diterima
-		cpu_irq_disable();		  //Interrupt dimatikan
-		if (incremental > 300)
-		{ //Jika hasil lebih dari 300 cm, dibulatkan menjadi 300 cm
-			score = 300;
-			snprintf(buffarray, sizeof(buffarray), "Panjang: %d cm  ", score);
-			gfx_mono_draw_string(buffarray, 0, 0, &sysfont);
-			delay_ms(100);
-			incremental = 0;
-			ioport_set_pin_level(LED0_GPIO, 0);
-			ioport_set_pin_level(LED1_GPIO, 0);
-			ioport_set_pin_level(LED2_GPIO, 0);
-		}
-		else
+		uint16_t distance;
+
+		if (ranging_get_distance(0, &distance))
 		{
-			int inc = newinc - oldinc;
-			int newscore = inc / 2; //Dibagi 2 seperti rumus sonar
-			snprintf(buffarray, sizeof(buffarray), "Panjang: %d cm  ", newscore);
-			gfx_mono_draw_string(buffarray, 0, 0, &sysfont);
-			delay_ms(100);
-			incremental = 0; //reset nilai variable incremental
-			ioport_set_pin_level(LED0_GPIO, 1);
-			ioport_set_pin_level(LED1_GPIO, 1);
-			ioport_set_pin_level(LED2_GPIO, 1);
+			if ((distance == RANGING_NO_ECHO) || (distance > MAX_DISTANCE))
+			{ //Jika hasil lebih dari 300 cm atau tidak ada echo, dibulatkan menjadi 300 cm
+				snprintf(buffarray, sizeof(buffarray), "Panjang: %d cm  ", MAX_DISTANCE / 10);
+				gfx_mono_draw_string(buffarray, 0, 0, &sysfont);
+				ioport_set_pin_level(LED0_GPIO, 0);
+				ioport_set_pin_level(LED1_GPIO, 0);
+				ioport_set_pin_level(LED2_GPIO, 0);
+			}
+			else
+			{
+				snprintf(buffarray, sizeof(buffarray), "Panjang: %u.%u cm  ", distance / 10, distance % 10);
+				gfx_mono_draw_string(buffarray, 0, 0, &sysfont);
+				ioport_set_pin_level(LED0_GPIO, 1);
+				ioport_set_pin_level(LED1_GPIO, 1);
+				ioport_set_pin_level(LED2_GPIO, 1);
+			}
 		}
+		//Tidur sampai interrupt berikutnya, paling lama satu hold-off
+		sleepmgr_enter_sleep();
 	}
 }
 
 /*
-*Keterangan: Kecepatan suara yang digunakan adalah 1/29 cm/us.
-*Hasil sedikit tidak akurat, kemungkinan karena salah pengimplementasian rumus. Mohon dikoreksi jika menemukan kesalahan pada kode ini
-*/
\ No newline at end of file
+*Keterangan: Kecepatan suara dihitung dari suhu udara (331,3 m/s + 0,606 m/s per derajat Celsius),
+*default 20 derajat, lihat ranging_set_temperature() dan conf_ranging.h.
+*/
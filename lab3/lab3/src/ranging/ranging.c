@@ -0,0 +1,286 @@
+/**
+ * \file
+ *
+ * \brief Ultrasonic ranging with input capture
+ *
+ */
+#include <asf.h>
+#include <conf_tc.h>
+#include "ranging.h"
+
+//! \internal Event multiplexer of the channel the echo is routed through
+#define RANGING_EVSYS_CHMUX \
+	(*(&EVSYS.CH0MUX + CONFIG_RANGING_EVSYS_CH))
+//! \internal Event source of the timer counter
+#define RANGING_TC_EVSEL \
+	((TC_EVSEL_t)(TC_EVSEL_CH0_gc + CONFIG_RANGING_EVSYS_CH))
+
+//! \internal Width of the trigger pulse
+#define RANGING_TRIGGER_US 5
+
+enum ranging_state {
+	//! Stopped
+	RANGING_STATE_IDLE,
+	//! Triggered, waiting for the echo pulse to end
+	RANGING_STATE_ECHO,
+	//! Waiting for the echoes to fade before the next trigger
+	RANGING_STATE_HOLDOFF,
+};
+
+static ranging_callback_t ranging_callback;
+//! \internal Pin number of each sensor
+static uint8_t ranging_pins[RANGING_MAX_SENSORS];
+static uint8_t ranging_nr_of_sensors;
+//! \internal Sensor being measured or last measured
+static uint8_t ranging_current;
+static enum ranging_state ranging_state;
+static volatile bool ranging_running;
+/**
+ * \internal
+ * \brief Millimetres per microsecond of echo, Q16
+ *
+ * Half the speed of sound, as the echo travels there and back.
+ */
+static uint16_t ranging_scale;
+
+//! \internal Last distance of each sensor
+static uint16_t ranging_distance[RANGING_MAX_SENSORS];
+//! \internal Sensors with a distance not yet read, bit n for sensor n
+static uint8_t ranging_ready;
+
+/**
+ * \internal
+ * \brief Trigger the current sensor and start timing its echo
+ *
+ * The echo pin is only routed to the timer counter after the trigger pulse,
+ * so the capture starts at the rising edge of the echo.
+ */
+static void ranging_trigger(void)
+{
+	PORT_t *port = &CONFIG_RANGING_PORT;
+	uint8_t pin = ranging_pins[ranging_current];
+
+	port->OUTSET = 1 << pin;
+	port->DIRSET = 1 << pin;
+	delay_us(RANGING_TRIGGER_US);
+	port->OUTCLR = 1 << pin;
+	port->DIRCLR = 1 << pin;
+
+	tc_write_period(&CONFIG_RANGING_TC, CONFIG_RANGING_TIMEOUT_US);
+	tc_restart(&CONFIG_RANGING_TC);
+	tc_clear_overflow(&CONFIG_RANGING_TC);
+	tc_clear_cc_interrupt(&CONFIG_RANGING_TC, TC_CCA);
+	RANGING_EVSYS_CHMUX = CONFIG_RANGING_EVSYS_PIN0 + pin;
+	tc_set_input_capture(&CONFIG_RANGING_TC, RANGING_TC_EVSEL, TC_EVACT_PW_gc);
+	ranging_state = RANGING_STATE_ECHO;
+}
+
+/**
+ * \internal
+ * \brief Store the result of the current sensor and start the hold-off
+ */
+static void ranging_complete(uint16_t distance)
+{
+	uint8_t sensor = ranging_current;
+
+	RANGING_EVSYS_CHMUX = EVSYS_CHMUX_OFF_gc;
+	tc_set_input_capture(&CONFIG_RANGING_TC, TC_EVSEL_OFF_gc, TC_EVACT_OFF_gc);
+	tc_write_period(&CONFIG_RANGING_TC, CONFIG_RANGING_HOLDOFF_US);
+	tc_restart(&CONFIG_RANGING_TC);
+	tc_clear_overflow(&CONFIG_RANGING_TC);
+	ranging_state = RANGING_STATE_HOLDOFF;
+
+	ranging_distance[sensor] = distance;
+	ranging_ready |= 1 << sensor;
+	if (ranging_callback) {
+		ranging_callback(sensor, distance);
+	}
+}
+
+/**
+ * \internal
+ * \brief Callback for the capture of the echo pulse width
+ */
+static void ranging_capture_handler(void)
+{
+	uint16_t width = tc_read_cc(&CONFIG_RANGING_TC, TC_CCA);
+
+	if (ranging_state != RANGING_STATE_ECHO) {
+		return;
+	}
+	ranging_complete(((uint32_t)width * ranging_scale) >> 16);
+}
+
+/**
+ * \internal
+ * \brief Callback for the timer overflow
+ *
+ * Ends a measurement without an echo, or a hold-off, after which the next
+ * sensor is triggered.
+ */
+static void ranging_overflow_handler(void)
+{
+	if (ranging_state == RANGING_STATE_ECHO) {
+		ranging_complete(RANGING_NO_ECHO);
+	} else if (ranging_state == RANGING_STATE_HOLDOFF) {
+		if (!ranging_running) {
+			tc_write_clock_source(&CONFIG_RANGING_TC, TC_CLKSEL_OFF_gc);
+			ranging_state = RANGING_STATE_IDLE;
+			return;
+		}
+		if (++ranging_current == ranging_nr_of_sensors) {
+			ranging_current = 0;
+		}
+		ranging_trigger();
+	}
+}
+
+/* A flag conf_tc.h leaves undefined stays an identifier, which #if takes
+ * as 0 */
+#ifdef CONFIG_RANGING_TC_BOUND
+#  if !(CONFIG_RANGING_TC_OVF_BOUND) || !(CONFIG_RANGING_TC_CCA_BOUND)
+#    error The ranging vectors must be marked bound in conf_tc.h
+#  endif
+/**
+ * \internal
+ * \brief Interrupts of the timer counter, bound to the handlers directly
+ *
+ * @{
+ */
+ISR(CONFIG_RANGING_TC_OVF_VECT)
+{
+	ranging_overflow_handler();
+}
+
+ISR(CONFIG_RANGING_TC_CCA_VECT)
+{
+	ranging_capture_handler();
+}
+//! @}
+#elif (CONFIG_RANGING_TC_OVF_BOUND) || (CONFIG_RANGING_TC_CCA_BOUND)
+#  error The ranging vectors are marked bound in conf_tc.h but not handled
+#endif
+
+/**
+ * \brief Initialize the sensor pins and the capture timer
+ *
+ * \param callback called from interrupt context with each result, or NULL
+ */
+void ranging_init(ranging_callback_t callback)
+{
+	PORT_t *port = &CONFIG_RANGING_PORT;
+
+	ranging_callback = callback;
+	ranging_nr_of_sensors = 0;
+	ranging_state = RANGING_STATE_IDLE;
+	ranging_running = false;
+	ranging_ready = 0;
+
+	/* Both edges must generate events for pulse width capture */
+	for (uint8_t pin = 0; pin < 8; pin++) {
+		if (CONFIG_RANGING_PINS & (1 << pin)) {
+			(&port->PIN0CTRL)[pin] = PORT_ISC_BOTHEDGES_gc;
+			ranging_pins[ranging_nr_of_sensors++] = pin;
+		}
+	}
+	port->OUTCLR = CONFIG_RANGING_PINS;
+	port->DIRCLR = CONFIG_RANGING_PINS;
+
+	ranging_set_temperature(CONFIG_RANGING_TEMPERATURE);
+
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_EVSYS);
+	RANGING_EVSYS_CHMUX = EVSYS_CHMUX_OFF_gc;
+
+	tc_enable(&CONFIG_RANGING_TC);
+#ifndef CONFIG_RANGING_TC_BOUND
+	tc_set_overflow_interrupt_callback(&CONFIG_RANGING_TC,
+			ranging_overflow_handler);
+	tc_set_cca_interrupt_callback(&CONFIG_RANGING_TC, ranging_capture_handler);
+#endif
+	tc_set_wgm(&CONFIG_RANGING_TC, TC_WG_NORMAL);
+	tc_enable_cc_channels(&CONFIG_RANGING_TC, TC_CCAEN);
+	tc_set_overflow_interrupt_level(&CONFIG_RANGING_TC, TC_INT_LVL_LO);
+	tc_set_cca_interrupt_level(&CONFIG_RANGING_TC, TC_INT_LVL_LO);
+}
+
+/**
+ * \brief Start measuring
+ *
+ * The sensors are measured in turn until ranging_stop() is called.
+ */
+void ranging_start(void)
+{
+	irqflags_t flags;
+
+	if (!ranging_nr_of_sensors) {
+		return;
+	}
+
+	flags = cpu_irq_save();
+	ranging_running = true;
+	if (ranging_state == RANGING_STATE_IDLE) {
+		ranging_current = 0;
+		tc_write_clock_source(&CONFIG_RANGING_TC, CONFIG_RANGING_TC_CLKSEL);
+		ranging_trigger();
+	}
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \brief Stop measuring
+ *
+ * The measurement in progress still completes.
+ */
+void ranging_stop(void)
+{
+	ranging_running = false;
+}
+
+/**
+ * \brief Set the air temperature used to compute distances
+ *
+ * The speed of sound is taken as 331.3 m/s + 0.606 m/s per degree Celsius.
+ *
+ * \param celsius the air temperature
+ */
+void ranging_set_temperature(int8_t celsius)
+{
+	/* Speed of sound in mm/s, times 2^16 / 2 / 10^6 = 4096 / 125000 */
+	uint32_t speed = 331300L + 606L * celsius;
+
+	ranging_scale = (speed * 4096) / 125000;
+}
+
+/**
+ * \brief Get the last distance measured by a sensor
+ *
+ * \param sensor the sensor number
+ * \param distance where to store the distance in millimetres, or
+ * RANGING_NO_ECHO
+ *
+ * \retval true if the distance is new since the last call
+ * \retval false if it was already read, or there is none yet
+ */
+bool ranging_get_distance(uint8_t sensor, uint16_t *distance)
+{
+	irqflags_t flags;
+	bool is_new;
+
+	Assert(sensor < ranging_nr_of_sensors);
+
+	flags = cpu_irq_save();
+	*distance = ranging_distance[sensor];
+	is_new = ranging_ready & (1 << sensor);
+	ranging_ready &= ~(1 << sensor);
+	cpu_irq_restore(flags);
+
+	return is_new;
+}
+
+/**
+ * \brief Get the number of configured sensors
+ */
+uint8_t ranging_get_nr_of_sensors(void)
+{
+	return ranging_nr_of_sensors;
+}
@@ -0,0 +1,46 @@
+/**
+ * \file
+ *
+ * \brief Ultrasonic ranging with input capture
+ *
+ * Drives single-pin ultrasonic sensors (trigger and echo on the same line)
+ * on the pins given in conf_ranging.h. The echo pin is routed through the
+ * event system to a timer counter in pulse width capture mode, so the echo
+ * is timed in hardware to the microsecond and the CPU is free while it
+ * waits.
+ *
+ * Sensors are triggered one at a time in turn, with a hold-off between them
+ * so one sensor does not pick up the echo of another. Each result is handed
+ * to the callback from the capture interrupt, and kept for
+ * ranging_get_distance().
+ *
+ * Distances are in millimetres, computed with the speed of sound at the air
+ * temperature set with ranging_set_temperature().
+ */
+#ifndef RANGING_H_INCLUDED
+#define RANGING_H_INCLUDED
+
+#include <compiler.h>
+#include <conf_ranging.h>
+
+//! Maximum number of sensors, one per pin of the port
+#define RANGING_MAX_SENSORS  8
+//! Distance reported when no echo came back before the timeout
+#define RANGING_NO_ECHO      0xffff
+
+/**
+ * \brief Callback for a completed measurement
+ *
+ * Called from the capture interrupt with the sensor number, counted from the
+ * lowest configured pin, and the distance in millimetres or RANGING_NO_ECHO.
+ */
+typedef void (*ranging_callback_t)(uint8_t sensor, uint16_t distance);
+
+void ranging_init(ranging_callback_t callback);
+void ranging_start(void);
+void ranging_stop(void);
+void ranging_set_temperature(int8_t celsius);
+bool ranging_get_distance(uint8_t sensor, uint16_t *distance);
+uint8_t ranging_get_nr_of_sensors(void);
+
+#endif /* RANGING_H_INCLUDED */